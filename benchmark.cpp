@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "config.hpp"
+#include "hashlife.hpp"
+#include "pool.hpp"
+#include "simulation.hpp"
+
+static double Benchmark(int bounds, int counting, Pool* pool = nullptr, bool sparse = false, int temporal = 1)
+{
+    Grid grid;
+    CreateGrid(grid, bounds, bounds, bounds);
+    grid.counting = counting;
+    grid.pool = pool;
+    grid.sparse = sparse;
+    Rules rules;
+    /* seed and copy */
+    StepGrid(grid, rules);
+    StepGrid(grid, rules);
+    grid.temporal = temporal;
+    int steps = std::max(4, 32 * (128 * 128 * 128) / (bounds * bounds * bounds));
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; i++)
+    {
+        StepGrid(grid, rules);
+    }
+    auto end = std::chrono::steady_clock::now();
+    /* per generation so that temporal blocking compares with single steps */
+    return std::chrono::duration<double, std::milli>(end - start).count() / (steps * temporal);
+}
+
+/* the seeded grids do not repeat, so few results are reused and long jumps take far longer than stepping */
+static double BenchmarkJump(int bounds, int steps)
+{
+    Grid grid;
+    CreateGrid(grid, bounds, bounds, bounds);
+    Rules rules;
+    StepGrid(grid, rules);
+    StepGrid(grid, rules);
+    Hashlife hashlife;
+    CreateHashlife(hashlife, 1 << 22);
+    auto start = std::chrono::steady_clock::now();
+    JumpGrid(hashlife, grid, rules, steps);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / steps;
+}
+
+/* cubes of 2x2x2 cells far apart in empty space, which these rules keep as they are, so the octree shares every cube
+ * and the empty space around it and long jumps reuse their results */
+static double BenchmarkSparseJump(int bounds, int steps)
+{
+    Grid grid;
+    CreateGrid(grid, bounds, bounds, bounds);
+    Rules rules;
+    /* each cell of a cube has seven live neighbors and no dead cell next to one has more than four */
+    rules.surviveMask = 1u << 7;
+    rules.birthMask = 1u << 8;
+    StepGrid(grid, rules);
+    StepGrid(grid, rules);
+    for (int z = 0; z < bounds; z++)
+    for (int y = 0; y < bounds; y++)
+    for (int x = 0; x < bounds; x++)
+    {
+        bool cube = x % 16 / 2 == 3 && y % 16 / 2 == 3 && z % 16 / 2 == 3;
+        SetCell(grid, x, y, z, cube ? rules.life : 0);
+    }
+    Hashlife hashlife;
+    CreateHashlife(hashlife, 1 << 22);
+    auto start = std::chrono::steady_clock::now();
+    JumpGrid(hashlife, grid, rules, steps);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / steps;
+}
+
+int main()
+{
+    const int sizes[] = {32, 64, 128, 256};
+    const char* names[] = {"direct", "bitboard", "separable"};
+    std::printf("%-8s %-10s %-6s %12s %8s\n", "bounds", "counting", "sparse", "ms/gen", "speedup");
+    for (int bounds : sizes)
+    {
+        double direct = Benchmark(bounds, COUNTING_DIRECT);
+        std::printf("%-8d %-10s %-6s %12.3f %8.2f\n", bounds, names[COUNTING_DIRECT], "no", direct, 1.0);
+        for (int counting : {COUNTING_BITBOARD, COUNTING_SEPARABLE})
+        {
+            double time = Benchmark(bounds, counting);
+            std::printf("%-8d %-10s %-6s %12.3f %8.2f\n", bounds, names[counting], "no", time, direct / time);
+        }
+        for (int counting : {COUNTING_DIRECT, COUNTING_BITBOARD})
+        {
+            double time = Benchmark(bounds, counting, nullptr, true);
+            std::printf("%-8d %-10s %-6s %12.3f %8.2f\n", bounds, names[counting], "yes", time, direct / time);
+        }
+    }
+    std::printf("\n%-8s %-10s %12s %8s\n", "bounds", "temporal", "ms/gen", "speedup");
+    for (int bounds : sizes)
+    {
+        double direct = Benchmark(bounds, COUNTING_DIRECT);
+        for (int temporal : {1, 2, 4, 8})
+        {
+            double time = Benchmark(bounds, COUNTING_DIRECT, nullptr, false, temporal);
+            std::printf("%-8d %-10d %12.3f %8.2f\n", bounds, temporal, time, direct / time);
+        }
+    }
+    std::printf("\n%-8s %-10s %12s %8s\n", "bounds", "engine", "ms/gen", "speedup");
+    for (int bounds : {32, 64, 128})
+    {
+        double direct = Benchmark(bounds, COUNTING_DIRECT);
+        double time = BenchmarkJump(bounds, 16);
+        std::printf("%-8d %-10s %12.3f %8.2f\n", bounds, "hashlife", time, direct / time);
+        time = BenchmarkSparseJump(bounds, 1024);
+        std::printf("%-8d %-10s %12.3f %8.2f\n", bounds, "cubes", time, direct / time);
+    }
+    int hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < hardware; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(hardware);
+    std::printf("\n%-8s %-10s %12s %8s\n", "threads", "counting", "steps/s", "scaling");
+    for (int counting : {COUNTING_DIRECT, COUNTING_BITBOARD, COUNTING_SEPARABLE})
+    {
+        double single = 0.0;
+        for (int threads : threadCounts)
+        {
+            Pool pool;
+            CreatePool(pool, threads);
+            double rate = 1000.0 / Benchmark(BOUNDS, counting, &pool);
+            DestroyPool(pool);
+            if (threads == 1)
+            {
+                single = rate;
+            }
+            std::printf("%-8d %-10s %12.1f %8.2f\n", threads, names[counting], rate, rate / single);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+/* the boxes of live cells in the newest frames, and the dispatch that covers the frames read and overwritten */
+struct Box
+{
+    uint minimum[3];
+    uint maximum[3];
+};
+
+layout(set = 1, binding = 1) buffer boundsBuffer
+{
+    /* indirect dispatch arguments first so that they sit at offset zero */
+    uint groups[3];
+    uint origin[3];
+    Box newest;
+    /* from the frame before the newest back to the one in the write texture */
+    Box older[FRAMES - 1];
+};
+
+shared uint sharedMinimum[3];
+shared uint sharedMaximum[3];
+
+/* the first cell of the group, offset by the first group of the dispatch */
+ivec3 GetGroupOrigin()
+{
+    return (ivec3(gl_WorkGroupID) + ivec3(origin[0], origin[1], origin[2])) * THREADS;
+}
+
+ivec3 GetId()
+{
+    return GetGroupOrigin() + ivec3(gl_LocalInvocationID);
+}
+
+/* grows the box of the frame being written by the live cells of the group, and must be reached by every invocation */
+void Grow(ivec3 id, bool alive)
+{
+    uint index = gl_LocalInvocationIndex;
+    if (index < 3)
+    {
+        sharedMinimum[index] = 0xFFFFFFFFu;
+        sharedMaximum[index] = 0;
+    }
+    barrier();
+    if (alive)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            atomicMin(sharedMinimum[i], uint(id[i]));
+            atomicMax(sharedMaximum[i], uint(id[i]));
+        }
+    }
+    barrier();
+    /* one atomic per group and axis rather than per cell */
+    if (index < 3 && sharedMinimum[index] <= sharedMaximum[index])
+    {
+        atomicMin(newest.minimum[index], sharedMinimum[index]);
+        atomicMax(newest.maximum[index], sharedMaximum[index]);
+    }
+}
@@ -0,0 +1,57 @@
+/* cells with an exposed face as their index, then their exposed faces in the low six bits and their value above */
+layout(set = 1, binding = 0) writeonly buffer faceBuffer
+{
+    uvec2 faces[];
+};
+/* an indirect draw whose instance count is reset to zero before every compaction */
+layout(set = 1, binding = 1) buffer drawBuffer
+{
+    uint vertices;
+    uint instances;
+    uint firstVertex;
+    uint firstInstance;
+};
+
+shared uint groupCount;
+shared uint groupFirst;
+
+/* faces in the order -x, +x, -y, +y, -z, +z whose neighbor is dead or outside the grid, from a GetCell of the includer */
+uint GetFaces(ivec3 id, ivec3 size)
+{
+    uint mask = 0;
+    for (int face = 0; face < 6; face++)
+    {
+        ivec3 neighbor = id;
+        neighbor[face / 2] += face % 2 == 0 ? -1 : 1;
+        if (any(lessThan(neighbor, ivec3(0))) || any(greaterThanEqual(neighbor, size)) || GetCell(neighbor) == 0)
+        {
+            mask |= 1u << face;
+        }
+    }
+    return mask;
+}
+
+/* appends the face of every visible cell of the group with one atomic per group, and must be reached by every invocation */
+void Append(uvec2 face, bool visible)
+{
+    if (gl_LocalInvocationIndex == 0)
+    {
+        groupCount = 0;
+    }
+    barrier();
+    uint offset = 0;
+    if (visible)
+    {
+        offset = atomicAdd(groupCount, 1);
+    }
+    barrier();
+    if (gl_LocalInvocationIndex == 0 && groupCount > 0)
+    {
+        groupFirst = atomicAdd(instances, groupCount);
+    }
+    barrier();
+    if (visible)
+    {
+        faces[groupFirst + offset] = face;
+    }
+}
@@ -1,14 +1,53 @@
 #ifndef CONFIG_HPP
 #define CONFIG_HPP
 
+/* default grid size when none is given */
 #define BOUNDS 128
 #define THREADS 8
-#define FRAMES 2
+/* cell textures on the gpu, so that a step writes one while the generation before the newest is drawn from another */
+#define FRAMES 3
+/* cell grids on the cpu, which step from one into the other */
+#define GRIDS 2
+
+#define STORAGE_BYTES 0
+#define STORAGE_BITS 1
+
+#define LAYOUT_TEXTURE 0
+#define LAYOUT_MORTON 1
+
+/* most generations per temporally blocked pass on the gpu, which sizes its shared memory */
+#define TEMPORAL 4
+
+/* milliseconds of simulation per frame when the speed is zero */
+#define TURBO 12
+
+/* age bins of the population stats, enough for the longest life */
+#define STATS_AGES 64
+/* stats downloads in flight so that they are read a few frames late without waiting on the gpu */
+#define READBACKS 4
+
+/* indirect dispatches spread groups along y past this many along x */
+#define DISPATCH 1024
+
+#define RENDER_FACES 0
+#define RENDER_GREEDY 1
+#define RENDER_MARCH 2
+/* greedy quads per chunk of THREADS^3 at most, as many as the faces between cells and their neighbors */
+#define MESH_QUADS (THREADS * THREADS * (THREADS * 3 + 3))
 
 /* neighborhoods */
 #define MOORE 0
 #define VON_NEUMANN 1
 
+/* boundaries */
+#define BOUNDARY_DEAD 0
+#define BOUNDARY_PERIODIC 1
+
+/* counting */
+#define COUNTING_DIRECT 0
+#define COUNTING_BITBOARD 1
+#define COUNTING_SEPARABLE 2
+
 /* camera */
 #define FOV 1.0f
 #define NEAR 0.1f
@@ -0,0 +1,54 @@
+/* the latest step and the one before it that changed each chunk or a face next to it, in pairs */
+layout(set = 1, binding = 0) buffer chunkBuffer
+{
+    uint chunks[];
+};
+layout(set = 2, binding = 0) uniform uniformSteps
+{
+    uint steps;
+};
+
+shared uint groupChanged;
+
+/* stamps the chunk of the group with the step if any of its cells changed, and the chunks across the faces that
+ * changed cells touch, and must be reached by every invocation */
+void Mark(ivec3 local, bool changed, ivec3 size)
+{
+    if (gl_LocalInvocationIndex == 0)
+    {
+        groupChanged = 0;
+    }
+    barrier();
+    if (changed)
+    {
+        /* the chunk itself, then the faces in the order -x, +x, -y, +y, -z, +z */
+        uint mask = 1;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            mask |= uint(local[axis] == 0) << (1 + axis * 2);
+            mask |= uint(local[axis] == THREADS - 1) << (2 + axis * 2);
+        }
+        atomicOr(groupChanged, mask);
+    }
+    barrier();
+    uint face = gl_LocalInvocationIndex;
+    if (face < 7 && ((groupChanged >> face) & 1) != 0)
+    {
+        ivec3 count = (size + THREADS - 1) / THREADS;
+        ivec3 chunk = ivec3(gl_WorkGroupID);
+        if (face > 0)
+        {
+            chunk[(face - 1) / 2] += (face - 1) % 2 == 0 ? -1 : 1;
+        }
+        if (all(greaterThanEqual(chunk, ivec3(0))) && all(lessThan(chunk, count)))
+        {
+            uint index = uint((chunk.z * count.y + chunk.y) * count.x + chunk.x);
+            /* only the first group to stamp a chunk in a step moves the latest step down */
+            uint latest = atomicExchange(chunks[index * 2], steps);
+            if (latest != steps)
+            {
+                chunks[index * 2 + 1] = latest;
+            }
+        }
+    }
+}
@@ -0,0 +1,42 @@
+/* the rules of each member of an ensemble, matching Rules on the cpu */
+struct Rules
+{
+    uint seed;
+    uint surviveMask;
+    uint birthMask;
+    uint life;
+    uint neighborhood;
+    uint frame;
+    uint boundary;
+};
+
+int Apply(Rules rules, int value, uint neighbors)
+{
+    if (value == 0 && ((rules.birthMask & (1u << neighbors)) != 0))
+    {
+        value = int(rules.life);
+    }
+    else if ((rules.surviveMask & (1u << neighbors)) == 0)
+    {
+        value--;
+    }
+    return max(0, value);
+}
+
+/* members are stacked along z without a halo, so each dispatch covers whole groups of every member */
+layout(set = 2, binding = 0) uniform uniformEnsemble
+{
+    int depth;
+};
+
+int GetMember()
+{
+    return int(gl_WorkGroupID.z) / ((depth + THREADS - 1) / THREADS);
+}
+
+ivec3 GetMemberCell(int member)
+{
+    ivec3 id = ivec3(gl_GlobalInvocationID);
+    id.z -= member * ((depth + THREADS - 1) / THREADS) * THREADS;
+    return id;
+}
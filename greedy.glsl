@@ -0,0 +1,140 @@
+/* written by dirty.comp or mortondirty.comp, next to the cells of the includer */
+layout(set = 0, binding = 1) readonly buffer chunkBuffer
+{
+    uint chunks[];
+};
+/* MESH_QUADS per chunk, each as the index of its first cell, then its face, extents less one and value */
+layout(set = 1, binding = 0) writeonly buffer quadBuffer
+{
+    uvec2 quads[];
+};
+struct Command
+{
+    uint vertices;
+    uint instances;
+    uint firstVertex;
+    uint firstInstance;
+};
+/* one indirect draw per chunk over its own quads */
+layout(set = 1, binding = 1) writeonly buffer commandBuffer
+{
+    Command commands[];
+};
+layout(set = 2, binding = 0) uniform uniformMesh
+{
+    /* steps of the drawn frame and of the one meshed before it, or every chunk is remeshed when full is set */
+    uint drawn;
+    uint meshed;
+    uint full;
+};
+
+const int Side = THREADS + 2;
+
+/* the cells of the chunk with a one cell border, dead outside the grid */
+shared uint groupCells[Side * Side * Side];
+shared uint groupQuads;
+
+/* the value of a cell of the chunk if its face along the step is exposed */
+uint GetFace(ivec3 cell, ivec3 step)
+{
+    cell += 1;
+    ivec3 neighbor = cell + step;
+    uint value = groupCells[(cell.z * Side + cell.y) * Side + cell.x];
+    return groupCells[(neighbor.z * Side + neighbor.y) * Side + neighbor.x] == 0 ? value : 0;
+}
+
+/* remeshes the chunk of the group when a step since it was last meshed changed it, from a GetCell of the includer,
+ * and must be reached by every invocation */
+void Mesh(ivec3 size)
+{
+    ivec3 count = (size + THREADS - 1) / THREADS;
+    ivec3 chunk = ivec3(gl_WorkGroupID);
+    uint index = uint((chunk.z * count.y + chunk.y) * count.x + chunk.x);
+    /* the newest frame is a step past the drawn one, so when it changed the chunk the step before is the one drawn */
+    uint latest = chunks[index * 2];
+    uint changed = latest <= drawn ? latest : chunks[index * 2 + 1];
+    if (full == 0 && changed <= meshed)
+    {
+        return;
+    }
+    ivec3 origin = chunk * THREADS;
+    for (uint i = gl_LocalInvocationIndex; i < Side * Side * Side; i += THREADS * THREADS * THREADS)
+    {
+        ivec3 id = origin - 1 + ivec3(i % Side, i / Side % Side, i / (Side * Side));
+        bool inside = all(greaterThanEqual(id, ivec3(0))) && all(lessThan(id, size));
+        groupCells[i] = inside ? GetCell(id) : 0;
+    }
+    if (gl_LocalInvocationIndex == 0)
+    {
+        groupQuads = 0;
+    }
+    barrier();
+    /* one invocation per slice of each face merges the exposed faces of the slice with the same value into quads */
+    if (gl_LocalInvocationIndex < 6 * THREADS)
+    {
+        uint face = gl_LocalInvocationIndex / THREADS;
+        int axis = int(face / 2);
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+        ivec3 step = ivec3(0);
+        step[axis] = face % 2 == 0 ? -1 : 1;
+        ivec3 cell;
+        cell[axis] = int(gl_LocalInvocationIndex % THREADS);
+        /* cells along u already in a quad, per row along v */
+        uint done[THREADS];
+        for (int j = 0; j < THREADS; j++)
+        {
+            done[j] = 0;
+        }
+        for (int j = 0; j < THREADS; j++)
+        {
+            for (int i = 0; i < THREADS; i++)
+            {
+                cell[u] = i;
+                cell[v] = j;
+                uint value = GetFace(cell, step);
+                if (((done[j] >> i) & 1) != 0 || value == 0)
+                {
+                    continue;
+                }
+                int width = 1;
+                for (; i + width < THREADS; width++)
+                {
+                    cell[u] = i + width;
+                    if (((done[j] >> (i + width)) & 1) != 0 || GetFace(cell, step) != value)
+                    {
+                        break;
+                    }
+                }
+                int height = 1;
+                for (bool grow = true; grow && j + height < THREADS; height += grow ? 1 : 0)
+                {
+                    cell[v] = j + height;
+                    for (int k = 0; grow && k < width; k++)
+                    {
+                        cell[u] = i + k;
+                        grow = ((done[j + height] >> (i + k)) & 1) == 0 && GetFace(cell, step) == value;
+                    }
+                }
+                uint row = ((1u << width) - 1) << i;
+                for (int k = 0; k < height; k++)
+                {
+                    done[j + k] |= row;
+                }
+                cell[u] = i;
+                cell[v] = j;
+                ivec3 id = origin + cell;
+                uint slot = atomicAdd(groupQuads, 1);
+                quads[index * MESH_QUADS + slot] = uvec2(
+                    uint((id.z * size.y + id.y) * size.x + id.x),
+                    face | (uint(width - 1) << 3) | (uint(height - 1) << 7) | (value << 11));
+                i += width - 1;
+            }
+        }
+    }
+    barrier();
+    if (gl_LocalInvocationIndex == 0)
+    {
+        commands[index] = Command(6u, groupQuads, 0u, index * MESH_QUADS);
+    }
+}
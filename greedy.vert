@@ -0,0 +1,34 @@
+#version 450
+
+/* instances are the quads of a chunk written by greedy.comp or mortongreedy.comp, from the first instance of its draw */
+layout(location = 0) in uvec2 inQuad;
+layout(location = 0) out flat uint outValue;
+layout(set = 1, binding = 0) uniform uniformViewProjMatrix
+{
+    mat4 viewProjMatrix;
+};
+layout(set = 1, binding = 1) uniform uniformSize
+{
+    ivec3 size;
+};
+
+void main()
+{
+    ivec3 cell;
+    cell.x = int(inQuad.x % uint(size.x));
+    cell.y = int(inQuad.x / uint(size.x) % uint(size.y));
+    cell.z = int(inQuad.x / uint(size.x * size.y));
+    uint face = inQuad.y & 7;
+    uint width = ((inQuad.y >> 3) & 15) + 1;
+    uint height = ((inQuad.y >> 7) & 15) + 1;
+    /* two triangles over the corners of the quad, which spans width cells along u and height along v */
+    const uint corners[6] = uint[6](0, 1, 2, 2, 1, 3);
+    uint corner = corners[gl_VertexIndex];
+    uint axis = face / 2;
+    vec3 position;
+    position[axis] = face % 2 == 0 ? -0.5f : 0.5f;
+    position[(axis + 1) % 3] = float((corner & 1) * width) - 0.5f;
+    position[(axis + 2) % 3] = float((corner >> 1) * height) - 0.5f;
+    outValue = inQuad.y >> 11;
+    gl_Position = viewProjMatrix * vec4(position + vec3(cell), 1.0f);
+}
@@ -0,0 +1,403 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "config.hpp"
+#include "hashlife.hpp"
+#include "simulation.hpp"
+
+/* cells outside of the grid, which are never alive and never change, past any value a cell can hold */
+static constexpr uint32_t Wall = 256;
+
+size_t NodeHash::operator()(const Node& node) const
+{
+    uint64_t hash = node.level;
+    for (int i = 0; i < 8; i++)
+    {
+        hash = (hash ^ node.children[i]) * 0x100000001b3ull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+static int GetChild(int x, int y, int z)
+{
+    return x + 2 * y + 4 * z;
+}
+
+static uint32_t Join(Hashlife& hashlife, uint32_t level, const uint32_t children[8])
+{
+    Node node{level, {}};
+    std::copy(children, children + 8, node.children);
+    uint32_t id = hashlife.freeIds.empty() ? hashlife.nodes.size() : hashlife.freeIds.back();
+    auto [it, inserted] = hashlife.ids.try_emplace(node, id);
+    if (!inserted)
+    {
+        return it->second;
+    }
+    if (hashlife.freeIds.empty())
+    {
+        hashlife.nodes.push_back(node);
+    }
+    else
+    {
+        hashlife.nodes[id] = node;
+        hashlife.freeIds.pop_back();
+    }
+    return id;
+}
+
+static uint32_t GetWall(Hashlife& hashlife, int level)
+{
+    while (static_cast<int>(hashlife.walls.size()) <= level)
+    {
+        /* level 0 is a single cell */
+        if (hashlife.walls.empty())
+        {
+            hashlife.walls.push_back(Wall);
+            continue;
+        }
+        uint32_t children[8];
+        std::fill(children, children + 8, hashlife.walls.back());
+        hashlife.walls.push_back(Join(hashlife, hashlife.walls.size(), children));
+    }
+    return hashlife.walls[level];
+}
+
+/* the 4x4x4 children of the children of a node */
+static void GetGrandchildren(const Hashlife& hashlife, const Node& node, uint32_t grandchildren[64])
+{
+    for (int z = 0; z < 4; z++)
+    for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++)
+    {
+        const Node& child = hashlife.nodes[node.children[GetChild(x / 2, y / 2, z / 2)]];
+        grandchildren[(z * 4 + y) * 4 + x] = child.children[GetChild(x % 2, y % 2, z % 2)];
+    }
+}
+
+/* joins the 2x2x2 grandchildren starting at x, y and z */
+static uint32_t JoinGrandchildren(Hashlife& hashlife, uint32_t level, const uint32_t grandchildren[64], int x, int y, int z)
+{
+    uint32_t children[8];
+    for (int dz = 0; dz < 2; dz++)
+    for (int dy = 0; dy < 2; dy++)
+    for (int dx = 0; dx < 2; dx++)
+    {
+        children[GetChild(dx, dy, dz)] = grandchildren[((z + dz) * 4 + y + dy) * 4 + x + dx];
+    }
+    return Join(hashlife, level, children);
+}
+
+/* steps the center 2x2x2 cells of a level 2 node by one generation */
+static uint32_t StepLeaf(Hashlife& hashlife, const Node& node)
+{
+    uint32_t cells[64];
+    GetGrandchildren(hashlife, node, cells);
+    uint32_t children[8];
+    for (int z = 1; z < 3; z++)
+    for (int y = 1; y < 3; y++)
+    for (int x = 1; x < 3; x++)
+    {
+        uint32_t value = cells[(z * 4 + y) * 4 + x];
+        if (value == Wall)
+        {
+            children[GetChild(x - 1, y - 1, z - 1)] = Wall;
+            continue;
+        }
+        uint32_t neighbors = 0;
+        for (int dz = -1; dz <= 1; dz++)
+        for (int dy = -1; dy <= 1; dy++)
+        for (int dx = -1; dx <= 1; dx++)
+        {
+            int distance = std::abs(dx) + std::abs(dy) + std::abs(dz);
+            if (distance == 0 || (hashlife.rules.neighborhood == VON_NEUMANN && distance > 1))
+            {
+                continue;
+            }
+            uint32_t neighbor = cells[((z + dz) * 4 + y + dy) * 4 + x + dx];
+            neighbors += neighbor > 0 && neighbor != Wall;
+        }
+        children[GetChild(x - 1, y - 1, z - 1)] = Apply(hashlife.rules, value, neighbors);
+    }
+    return Join(hashlife, 1, children);
+}
+
+static void Mark(const Hashlife& hashlife, uint32_t id, std::vector<uint8_t>& marks)
+{
+    if (marks[id])
+    {
+        return;
+    }
+    marks[id] = 1;
+    const Node& node = hashlife.nodes[id];
+    if (node.level > 1)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            Mark(hashlife, node.children[i], marks);
+        }
+    }
+}
+
+/*
+ * evicts every result and every node that is not reachable from the root or the stack.
+ * ids of the remaining nodes are kept so that the steps in progress stay valid
+ */
+static void Collect(Hashlife& hashlife)
+{
+    std::vector<uint8_t> marks(hashlife.nodes.size(), 0);
+    Mark(hashlife, hashlife.root, marks);
+    for (uint32_t id : hashlife.stack)
+    {
+        Mark(hashlife, id, marks);
+    }
+    for (size_t i = 1; i < hashlife.walls.size(); i++)
+    {
+        Mark(hashlife, hashlife.walls[i], marks);
+    }
+    for (uint32_t id = 0; id < hashlife.nodes.size(); id++)
+    {
+        Node& node = hashlife.nodes[id];
+        if (marks[id] || node.level == 0)
+        {
+            continue;
+        }
+        hashlife.ids.erase(node);
+        hashlife.freeIds.push_back(id);
+        node.level = 0;
+    }
+    hashlife.results.clear();
+    /* the working set of a single step can be larger than the capacity */
+    hashlife.limit = std::max(hashlife.capacity, 2 * hashlife.ids.size());
+}
+
+/* returns the center of a level k node stepped by 2^j generations where j <= k - 2 */
+static uint32_t Step(Hashlife& hashlife, uint32_t id, int j)
+{
+    uint64_t key = (uint64_t(id) << 6) | j;
+    auto it = hashlife.results.find(key);
+    if (it != hashlife.results.end())
+    {
+        return it->second;
+    }
+    /* every node below is pushed so that collecting in a nested step keeps it */
+    size_t stack = hashlife.stack.size();
+    hashlife.stack.push_back(id);
+    if (hashlife.ids.size() > hashlife.limit || hashlife.results.size() > hashlife.limit)
+    {
+        Collect(hashlife);
+    }
+    /* copied since joining below may grow the nodes */
+    Node node = hashlife.nodes[id];
+    uint32_t result;
+    if (node.level == 2)
+    {
+        result = StepLeaf(hashlife, node);
+    }
+    else
+    {
+        uint32_t level = node.level;
+        uint32_t grandchildren[64];
+        GetGrandchildren(hashlife, node, grandchildren);
+        /* the first half steps the 3x3x3 overlapping nodes or takes their centers when j is smaller */
+        bool full = j == static_cast<int>(level) - 2;
+        uint32_t halves[27];
+        for (int z = 0; z < 3; z++)
+        for (int y = 0; y < 3; y++)
+        for (int x = 0; x < 3; x++)
+        {
+            uint32_t child = JoinGrandchildren(hashlife, level - 1, grandchildren, x, y, z);
+            uint32_t& half = halves[(z * 3 + y) * 3 + x];
+            if (full)
+            {
+                hashlife.stack.push_back(child);
+                half = Step(hashlife, child, j - 1);
+            }
+            else
+            {
+                uint32_t childGrandchildren[64];
+                GetGrandchildren(hashlife, hashlife.nodes[child], childGrandchildren);
+                half = JoinGrandchildren(hashlife, level - 2, childGrandchildren, 1, 1, 1);
+            }
+            hashlife.stack.push_back(half);
+        }
+        /* the second half steps the 2x2x2 overlapping nodes made from the first */
+        uint32_t children[8];
+        for (int z = 0; z < 2; z++)
+        for (int y = 0; y < 2; y++)
+        for (int x = 0; x < 2; x++)
+        {
+            uint32_t quarters[8];
+            for (int dz = 0; dz < 2; dz++)
+            for (int dy = 0; dy < 2; dy++)
+            for (int dx = 0; dx < 2; dx++)
+            {
+                quarters[GetChild(dx, dy, dz)] = halves[((z + dz) * 3 + y + dy) * 3 + x + dx];
+            }
+            uint32_t child = Join(hashlife, level - 1, quarters);
+            hashlife.stack.push_back(child);
+            children[GetChild(x, y, z)] = Step(hashlife, child, full ? j - 1 : j);
+            hashlife.stack.push_back(children[GetChild(x, y, z)]);
+        }
+        result = Join(hashlife, level - 1, children);
+    }
+    hashlife.stack.resize(stack);
+    hashlife.results.emplace(key, result);
+    return result;
+}
+
+/* surrounds a level k node with walls so that it becomes the center of a level k + 1 node */
+static uint32_t Expand(Hashlife& hashlife, uint32_t id)
+{
+    Node node = hashlife.nodes[id];
+    uint32_t wall = GetWall(hashlife, node.level - 1);
+    uint32_t children[8];
+    for (int i = 0; i < 8; i++)
+    {
+        uint32_t grandchildren[8];
+        std::fill(grandchildren, grandchildren + 8, wall);
+        /* the opposite corner of each child faces the center */
+        grandchildren[7 - i] = node.children[i];
+        children[i] = Join(hashlife, node.level, grandchildren);
+    }
+    return Join(hashlife, node.level + 1, children);
+}
+
+static uint32_t Build(Hashlife& hashlife, const Grid& grid, int level, int x, int y, int z)
+{
+    int size = 1 << level;
+    int x1 = x - hashlife.offset;
+    int y1 = y - hashlife.offset;
+    int z1 = z - hashlife.offset;
+    if (x1 + size <= 0 || y1 + size <= 0 || z1 + size <= 0 ||
+        x1 >= grid.width || y1 >= grid.height || z1 >= grid.depth)
+    {
+        return GetWall(hashlife, level);
+    }
+    uint32_t children[8];
+    size /= 2;
+    for (int dz = 0; dz < 2; dz++)
+    for (int dy = 0; dy < 2; dy++)
+    for (int dx = 0; dx < 2; dx++)
+    {
+        uint32_t& child = children[GetChild(dx, dy, dz)];
+        if (level > 1)
+        {
+            child = Build(hashlife, grid, level - 1, x + dx * size, y + dy * size, z + dz * size);
+            continue;
+        }
+        int cx = x1 + dx;
+        int cy = y1 + dy;
+        int cz = z1 + dz;
+        bool inside = cx >= 0 && cy >= 0 && cz >= 0 && cx < grid.width && cy < grid.height && cz < grid.depth;
+        child = inside ? GetCell(grid, cx, cy, cz) : Wall;
+    }
+    return Join(hashlife, level, children);
+}
+
+static void Store(const Hashlife& hashlife, Grid& grid, uint32_t id, int x, int y, int z)
+{
+    const Node& node = hashlife.nodes[id];
+    int size = 1 << node.level;
+    int x1 = x - hashlife.offset;
+    int y1 = y - hashlife.offset;
+    int z1 = z - hashlife.offset;
+    if (x1 + size <= 0 || y1 + size <= 0 || z1 + size <= 0 ||
+        x1 >= grid.width || y1 >= grid.height || z1 >= grid.depth)
+    {
+        return;
+    }
+    size /= 2;
+    for (int dz = 0; dz < 2; dz++)
+    for (int dy = 0; dy < 2; dy++)
+    for (int dx = 0; dx < 2; dx++)
+    {
+        uint32_t child = node.children[GetChild(dx, dy, dz)];
+        if (node.level > 1)
+        {
+            Store(hashlife, grid, child, x + dx * size, y + dy * size, z + dz * size);
+            continue;
+        }
+        int cx = x1 + dx;
+        int cy = y1 + dy;
+        int cz = z1 + dz;
+        if (cx >= 0 && cy >= 0 && cz >= 0 && cx < grid.width && cy < grid.height && cz < grid.depth)
+        {
+            SetCell(grid, cx, cy, cz, child);
+        }
+    }
+}
+
+/* steps the root by 2^j generations */
+static void Advance(Hashlife& hashlife, int j)
+{
+    /* the grid must stay inside the center half and the root must be at least level j + 2 */
+    while (hashlife.level < j + 2)
+    {
+        hashlife.root = Expand(hashlife, hashlife.root);
+        hashlife.offset += 1 << (hashlife.level - 1);
+        hashlife.level++;
+    }
+    hashlife.root = Expand(hashlife, Step(hashlife, hashlife.root, j));
+}
+
+void CreateHashlife(Hashlife& hashlife, size_t capacity)
+{
+    hashlife.nodes.clear();
+    hashlife.ids.clear();
+    hashlife.results.clear();
+    hashlife.walls.clear();
+    hashlife.freeIds.clear();
+    hashlife.stack.clear();
+    hashlife.capacity = capacity;
+    hashlife.limit = capacity;
+    hashlife.rules = Rules{};
+}
+
+void JumpGrid(Hashlife& hashlife, Grid& grid, Rules& rules, uint64_t generations)
+{
+    /* seeding and copying are not generations of the rules */
+    for (; generations > 0 && rules.frame < 2; generations--)
+    {
+        StepGrid(grid, rules);
+    }
+    /* walls cannot wrap around so periodic grids are stepped one generation at a time */
+    int temporal = grid.temporal;
+    grid.temporal = 1;
+    for (; generations > 0 && rules.boundary == BOUNDARY_PERIODIC; generations--)
+    {
+        StepGrid(grid, rules);
+    }
+    grid.temporal = temporal;
+    if (generations == 0)
+    {
+        return;
+    }
+    if (rules.surviveMask != hashlife.rules.surviveMask || rules.birthMask != hashlife.rules.birthMask ||
+        rules.life != hashlife.rules.life || rules.neighborhood != hashlife.rules.neighborhood)
+    {
+        hashlife.results.clear();
+    }
+    hashlife.rules = rules;
+    /* the smallest root where the grid fits inside the center half */
+    int size = std::max({grid.width, grid.height, grid.depth, 2});
+    hashlife.level = 1;
+    while ((1 << (hashlife.level - 1)) < size)
+    {
+        hashlife.level++;
+    }
+    hashlife.level = std::max(hashlife.level, 2);
+    hashlife.offset = 1 << (hashlife.level - 2);
+    hashlife.root = Build(hashlife, grid, hashlife.level, 0, 0, 0);
+    for (int j = 0; j < 64; j++)
+    {
+        if (generations & (1ull << j))
+        {
+            Advance(hashlife, j);
+        }
+    }
+    Store(hashlife, grid, hashlife.root, 0, 0, 0);
+    rules.frame += generations;
+}
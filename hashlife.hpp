@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "simulation.hpp"
+
+/* 2x2x2 cells at level 1 and 8 nodes of the level below otherwise, indexed by x + 2y + 4z */
+struct Node
+{
+    uint32_t level;
+    uint32_t children[8];
+
+    bool operator==(const Node& other) const = default;
+};
+
+struct NodeHash
+{
+    size_t operator()(const Node& node) const;
+};
+
+/*
+ * octree of the grid where identical nodes are shared and the result of stepping a node by
+ * 2^j generations is memoized, so repetitive patterns can jump far ahead (3d hashlife)
+ */
+struct Hashlife
+{
+    std::vector<Node> nodes;
+    std::unordered_map<Node, uint32_t, NodeHash> ids;
+    /* keyed by the node and j */
+    std::unordered_map<uint64_t, uint32_t> results;
+    /* nodes filled with walls per level, which surround the grid and never change */
+    std::vector<uint32_t> walls;
+    /* evicted nodes, which have a level of 0 until reused */
+    std::vector<uint32_t> freeIds;
+    /* nodes in use by the steps in progress */
+    std::vector<uint32_t> stack;
+    /* nodes and results are evicted once either grows past this */
+    size_t capacity;
+    size_t limit;
+    Rules rules;
+    uint32_t root;
+    int level;
+    /* position of the grid inside the root along each axis */
+    int offset;
+    int width;
+    int height;
+    int depth;
+};
+
+void CreateHashlife(Hashlife& hashlife, size_t capacity);
+/* same as stepping the grid by the number of generations */
+void JumpGrid(Hashlife& hashlife, Grid& grid, Rules& rules, uint64_t generations);
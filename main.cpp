@@ -10,25 +10,111 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <format>
+#include <fstream>
+#include <string>
+#include <vector>
 
 #include "config.hpp"
 #include "shader.hpp"
+#include "simulation.hpp"
 
-static_assert(BOUNDS < 1024);
-static_assert(FRAMES == 2, "not implemented");
+/* matches statsBuffer in stats.comp */
+struct Stats
+{
+    uint32_t alive;
+    uint32_t births;
+    uint32_t deaths;
+    uint32_t minimum[3];
+    uint32_t maximum[3];
+    uint32_t ages[STATS_AGES];
+};
+
+/* for marching rays from the eye through the cells */
+struct Camera
+{
+    glm::mat4 inverseViewProjMatrix;
+    glm::vec4 position;
+    int32_t size[4];
+};
 
 static SDL_Window* window;
 static SDL_GPUDevice* device;
 static SDL_GPUGraphicsPipeline* graphicsPipeline;
-static SDL_GPUComputePipeline* computePipeline;
+static SDL_GPUGraphicsPipeline* greedyGraphicsPipeline;
+static SDL_GPUGraphicsPipeline* marchGraphicsPipeline;
+static SDL_GPUGraphicsPipeline* mortonMarchGraphicsPipeline;
+static SDL_GPUComputePipeline* initPipeline;
+static SDL_GPUComputePipeline* computePipelines[4];
+static SDL_GPUComputePipeline* sumPipeline;
+static SDL_GPUComputePipeline* separablePipeline;
+static SDL_GPUComputePipeline* bricksPipeline;
+static SDL_GPUComputePipeline* sparsePipelines[4];
+static SDL_GPUComputePipeline* haloPipeline;
+static SDL_GPUComputePipeline* temporalPipelines[4];
+static SDL_GPUComputePipeline* tiledPipelines[4];
+static SDL_GPUComputePipeline* subgroupPipelines[4];
+static SDL_GPUComputePipeline* packPipeline;
+static SDL_GPUComputePipeline* packedPipelines[4];
+static SDL_GPUComputePipeline* mortonInitPipeline;
+static SDL_GPUComputePipeline* mortonPipelines[4];
+static SDL_GPUComputePipeline* ensembleInitPipeline;
+static SDL_GPUComputePipeline* ensemblePipeline;
+static SDL_GPUComputePipeline* statsPipeline;
+static SDL_GPUComputePipeline* mortonStatsPipeline;
+static SDL_GPUComputePipeline* boundsPipeline;
+static SDL_GPUComputePipeline* compactPipeline;
+static SDL_GPUComputePipeline* mortonCompactPipeline;
+static SDL_GPUComputePipeline* dirtyPipeline;
+static SDL_GPUComputePipeline* mortonDirtyPipeline;
+static SDL_GPUComputePipeline* greedyPipeline;
+static SDL_GPUComputePipeline* mortonGreedyPipeline;
+static SDL_GPUComputePipeline* occupancyPipeline;
+static SDL_GPUComputePipeline* mortonOccupancyPipeline;
+static SDL_GPUComputePipeline* superbricksPipeline;
 static SDL_GPUTexture* textures[FRAMES];
+static SDL_GPUTexture* sumTextures[2];
+/* occupancy with 32 cells per texel along x and no halo, next to the ages in textures */
+static SDL_GPUTexture* bitTextures[FRAMES];
+static bool bitsValid[FRAMES];
+/* whether each brick of THREADS^3 cells and each superbrick of THREADS^3 bricks has a live cell, so that empty space is skipped */
+static SDL_GPUTexture* brickTextures[FRAMES];
+static SDL_GPUTexture* superbrickTextures[FRAMES];
+/* cells in bricks of THREADS^3 ordered along a z-order curve, four to a word and without a halo */
+static SDL_GPUBuffer* cellBuffers[FRAMES];
+static SDL_GPUBuffer* bricksBuffer;
+static SDL_GPUBuffer* changedBuffer;
+static SDL_GPUBuffer* argsBuffer;
+static SDL_GPUBuffer* boundsBuffer;
+static int gridWidth{BOUNDS};
+static int gridHeight{BOUNDS};
+static int gridDepth{BOUNDS};
+static int bricksX;
+static int bricksY;
+static int bricksZ;
+/* a step reads the newest frame and overwrites the oldest while the frame before the newest is drawn */
 static int readFrame{0};
 static int writeFrame{1};
-static SDL_GPUBuffer* vertexBuffer;
-static SDL_GPUBuffer* instanceBuffer;
+static int drawFrame{FRAMES - 1};
+/* live cells of the drawn frame with their exposed faces, compacted before every draw and only created while drawn */
+static SDL_GPUBuffer* faceBuffer;
+static SDL_GPUBuffer* drawBuffer;
+static SDL_GPUTransferBuffer* drawTransferBuffer;
+/* greedy quads and a draw per chunk of THREADS^3, remeshed before drawing when their cells changed */
+static int render{RENDER_FACES};
+static SDL_GPUBuffer* chunkBuffer;
+static SDL_GPUBuffer* quadBuffer;
+static SDL_GPUBuffer* chunkDrawBuffer;
+/* steps taken and those of each frame, so that a chunk is remeshed when it changed after the frame meshed before */
+static uint32_t steps;
+static uint32_t frameSteps[FRAMES];
+/* chunks are only stamped by steps past this one, so meshes older than it are remeshed in full */
+static uint32_t trackedSteps;
+static uint32_t meshedSteps;
 static SDL_GPUTexture* depthTexture;
 static int depthTextureWidth;
 static int depthTextureHeight;
@@ -39,34 +125,69 @@ static uint64_t time1;
 static uint64_t time2;
 static float delta;
 static float delay{10.0f};
+/* generations recorded per batch when the speed is zero */
+static int turboSteps{1};
 static bool imguiFocused;
+static int counting{COUNTING_DIRECT};
+static bool sparse;
+static bool sparseTracked;
+static uint32_t sparseSlot;
+static Rules sparseRules;
+/* direct steps only cover the live cells of both frames when set */
+static bool shrink{true};
+/* the boxes are only grown by direct steps */
+static bool boundsTracked;
+static int temporal{1};
+/* counts neighbors from shared memory unless --untiled is passed or the pipeline fails to load */
+static bool tiled{true};
+/* shares rows between lanes of a subgroup, before the tile, when --subgroups is passed since sdl has no query for subgroup support */
+static bool subgroups;
+static int storage{STORAGE_BYTES};
+static int layout{LAYOUT_TEXTURE};
+/* times both layouts and exits when --benchmark is passed */
+static bool benchmark;
+/* members stacked along z in one texture per frame, each with its own rules, when --ensemble is passed */
+static int ensemble;
+static int member;
+static std::vector<Rules> members;
+/* rules of the first members when --ensemble-rules is passed, and the rest start with the same rules */
+static const char* memberRulesPath;
+static std::vector<Rules> memberRules;
+static SDL_GPUTexture* ensembleTextures[FRAMES];
+static SDL_GPUBuffer* membersBuffer;
+static SDL_GPUTransferBuffer* membersTransferBuffer;
+/* steps this many generations without drawing, logs their stats and exits when --headless is passed */
+static int headless;
+/* submitted batches of generations are kept in a ring until their fence signals, oldest first, along with their stats */
+static SDL_GPUBuffer* statsBuffer;
+static SDL_GPUTransferBuffer* statsTransferBuffers[READBACKS];
+static SDL_GPUFence* batchFences[READBACKS];
+static bool batchMeasured[READBACKS];
+static uint32_t batchFrames[READBACKS];
+/* turbo batches record their generations and submit time so that the next is sized once they retire */
+static int batchSteps[READBACKS];
+static uint64_t batchStarts[READBACKS];
+/* the last poll that found each batch unfinished, which bounds its time from below since fences are only polled once a frame */
+static uint64_t batchBusy[READBACKS];
+static uint64_t retiredTime;
+static int batchHead;
+static int batchTail;
+static Stats stats;
+static uint32_t statsFrame;
+static bool statsValid;
 
-struct
-{
-    uint32_t seed{0};
-    uint32_t surviveMask{16};
-    uint32_t birthMask{96};
-    uint32_t life{32};
-    uint32_t neighborhood{MOORE};
-    uint32_t frame{0};
-}
-static rules;
+static Rules rules;
 
 static bool Init()
 {
     SDL_SetAppMetadata("3D Cellular Automata", nullptr, nullptr);
     SDL_SetLogPriorities(SDL_LOG_PRIORITY_VERBOSE);
-    if (!SDL_Init(SDL_INIT_VIDEO))
+    /* headless runs only need the device and work without a display */
+    if (!SDL_Init(headless > 0 ? 0 : SDL_INIT_VIDEO))
     {
         SDL_Log("Failed to initialize SDL: %s", SDL_GetError());
         return false;
     }
-    window = SDL_CreateWindow("3D Cellular Automata", 960, 720, SDL_WINDOW_RESIZABLE);
-    if (!window)
-    {
-        SDL_Log("Failed to create window: %s", SDL_GetError());
-        return false;
-    }
 #if defined(SDL_PLATFORM_WIN32)
     device = SDL_CreateGPUDevice(SDL_GPU_SHADERFORMAT_DXIL, true, nullptr);
 #elif defined(SDL_PLATFORM_APPLE)
@@ -79,6 +200,16 @@ static bool Init()
         SDL_Log("Failed to create device: %s", SDL_GetError());
         return false;
     }
+    if (headless > 0)
+    {
+        return true;
+    }
+    window = SDL_CreateWindow("3D Cellular Automata", 960, 720, SDL_WINDOW_RESIZABLE);
+    if (!window)
+    {
+        SDL_Log("Failed to create window: %s", SDL_GetError());
+        return false;
+    }
     if (!SDL_ClaimWindowForGPUDevice(device, window))
     {
         SDL_Log("Failed to create swapchain: %s", SDL_GetError());
@@ -94,41 +225,63 @@ static bool Init()
     return true;
 }
 
-static bool CreatePipelines()
+/* variants are indexed by neighborhood and then boundary, and kernels that do not read the boundary share one per neighborhood */
+static bool LoadVariants(SDL_GPUComputePipeline* pipelines[4], const char* name, bool boundaries)
+{
+    const char* neighborhoods[] = {"moore", "von_neumann"};
+    const char* boundaryNames[] = {"dead", "periodic"};
+    for (int neighborhood = 0; neighborhood < 2; neighborhood++)
+    for (int boundary = 0; boundary < 2; boundary++)
+    {
+        int index = neighborhood * 2 + boundary;
+        if (!boundaries && boundary > 0)
+        {
+            pipelines[index] = pipelines[index - 1];
+            continue;
+        }
+        std::string variant = boundaries ?
+            std::format("{}_{}_{}.comp", name, neighborhoods[neighborhood], boundaryNames[boundary]) :
+            std::format("{}_{}.comp", name, neighborhoods[neighborhood]);
+        pipelines[index] = LoadComputePipeline(device, variant);
+        if (!pipelines[index])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void ReleaseVariants(SDL_GPUComputePipeline* pipelines[4])
+{
+    for (int i = 0; i < 4; i++)
+    {
+        if (i % 2 == 0 || pipelines[i] != pipelines[i - 1])
+        {
+            SDL_ReleaseGPUComputePipeline(device, pipelines[i]);
+        }
+    }
+}
+
+/* switching the neighborhood or boundary switches pipelines instead of branching per cell */
+static SDL_GPUComputePipeline* GetVariant(SDL_GPUComputePipeline* pipelines[4])
+{
+    return pipelines[rules.neighborhood * 2 + rules.boundary];
+}
+
+/* headless runs have no swapchain to draw into and skip these */
+static bool CreateGraphicsPipelines()
 {
     SDL_GPUShader* vertShader = LoadShader(device, "render.vert");
+    SDL_GPUShader* greedyVertShader = LoadShader(device, "greedy.vert");
     SDL_GPUShader* fragShader = LoadShader(device, "render.frag");
-    if (!vertShader || !fragShader)
+    SDL_GPUShader* marchVertShader = LoadShader(device, "march.vert");
+    SDL_GPUShader* marchFragShader = LoadShader(device, "march.frag");
+    SDL_GPUShader* mortonMarchFragShader = LoadShader(device, "mortonmarch.frag");
+    if (!vertShader || !greedyVertShader || !fragShader || !marchVertShader || !marchFragShader || !mortonMarchFragShader)
     {
         SDL_Log("Failed to load shader(s)");
         return false;
     }
-    SDL_GPUVertexBufferDescription buffers[2] =
-    {{
-        .slot = 0,
-        .pitch = sizeof(float) * 3,
-        .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
-        .instance_step_rate = 0,
-    },
-    {
-        .slot = 1,
-        .pitch = sizeof(uint32_t),
-        .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
-        .instance_step_rate = 0,
-    }};
-    SDL_GPUVertexAttribute attribs[2] =
-    {{
-        .location = 0,
-        .buffer_slot = 0,
-        .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-        .offset = 0,
-    },
-    {
-        .location = 1,
-        .buffer_slot = 1,
-        .format = SDL_GPU_VERTEXELEMENTFORMAT_UINT,
-        .offset = 0,
-    }};
     SDL_GPUColorTargetDescription targets[1] =
     {{
         .format = SDL_GetGPUSwapchainTextureFormat(device, window),
@@ -136,10 +289,6 @@ static bool CreatePipelines()
     SDL_GPUGraphicsPipelineCreateInfo info{};
     info.vertex_shader = vertShader;
     info.fragment_shader = fragShader;
-    info.vertex_input_state.vertex_buffer_descriptions = buffers;
-    info.vertex_input_state.num_vertex_buffers = 2;
-    info.vertex_input_state.vertex_attributes = attribs;
-    info.vertex_input_state.num_vertex_attributes = 2;
     info.target_info.color_target_descriptions = targets;
     info.target_info.num_color_targets = 1;
     info.target_info.depth_stencil_format = SDL_GPU_TEXTUREFORMAT_D32_FLOAT;
@@ -148,31 +297,108 @@ static bool CreatePipelines()
     info.depth_stencil_state.enable_depth_test = true;
     info.depth_stencil_state.enable_depth_write = true;
     graphicsPipeline = SDL_CreateGPUGraphicsPipeline(device, &info);
-    computePipeline = LoadComputePipeline(device, "automata.comp");
-    if (!graphicsPipeline || !computePipeline)
+    SDL_GPUVertexBufferDescription buffers[1] =
+    {{
+        .slot = 0,
+        .pitch = sizeof(uint32_t) * 2,
+        .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+        .instance_step_rate = 0,
+    }};
+    SDL_GPUVertexAttribute attribs[1] =
+    {{
+        .location = 0,
+        .buffer_slot = 0,
+        .format = SDL_GPU_VERTEXELEMENTFORMAT_UINT2,
+        .offset = 0,
+    }};
+    /* quads are instances so that the draw of each chunk starts at its own */
+    info.vertex_shader = greedyVertShader;
+    info.vertex_input_state.vertex_buffer_descriptions = buffers;
+    info.vertex_input_state.num_vertex_buffers = 1;
+    info.vertex_input_state.vertex_attributes = attribs;
+    info.vertex_input_state.num_vertex_attributes = 1;
+    greedyGraphicsPipeline = SDL_CreateGPUGraphicsPipeline(device, &info);
+    /* rays find the nearest live cell themselves */
+    info.vertex_shader = marchVertShader;
+    info.fragment_shader = marchFragShader;
+    info.vertex_input_state = {};
+    info.depth_stencil_state.enable_depth_test = false;
+    info.depth_stencil_state.enable_depth_write = false;
+    marchGraphicsPipeline = SDL_CreateGPUGraphicsPipeline(device, &info);
+    info.fragment_shader = mortonMarchFragShader;
+    mortonMarchGraphicsPipeline = SDL_CreateGPUGraphicsPipeline(device, &info);
+    SDL_ReleaseGPUShader(device, vertShader);
+    SDL_ReleaseGPUShader(device, greedyVertShader);
+    SDL_ReleaseGPUShader(device, fragShader);
+    SDL_ReleaseGPUShader(device, marchVertShader);
+    SDL_ReleaseGPUShader(device, marchFragShader);
+    SDL_ReleaseGPUShader(device, mortonMarchFragShader);
+    if (!graphicsPipeline || !greedyGraphicsPipeline || !marchGraphicsPipeline || !mortonMarchGraphicsPipeline)
     {
-        SDL_Log("Failed to create pipeline(s): %s", SDL_GetError());
+        SDL_Log("Failed to create graphics pipeline(s): %s", SDL_GetError());
         return false;
     }
-    SDL_ReleaseGPUShader(device, vertShader);
-    SDL_ReleaseGPUShader(device, fragShader);
     return true;
 }
 
-static bool CreateResources()
+static bool CreatePipelines()
 {
-    SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(device);
-    if (!commandBuffer)
+    initPipeline = LoadComputePipeline(device, "init.comp");
+    sumPipeline = LoadComputePipeline(device, "sum.comp");
+    separablePipeline = LoadComputePipeline(device, "separable.comp");
+    bricksPipeline = LoadComputePipeline(device, "bricks.comp");
+    haloPipeline = LoadComputePipeline(device, "halo.comp");
+    packPipeline = LoadComputePipeline(device, "pack.comp");
+    mortonInitPipeline = LoadComputePipeline(device, "mortoninit.comp");
+    ensembleInitPipeline = LoadComputePipeline(device, "ensembleinit.comp");
+    ensemblePipeline = LoadComputePipeline(device, "ensemble.comp");
+    statsPipeline = LoadComputePipeline(device, "stats.comp");
+    mortonStatsPipeline = LoadComputePipeline(device, "mortonstats.comp");
+    boundsPipeline = LoadComputePipeline(device, "bounds.comp");
+    compactPipeline = LoadComputePipeline(device, "compact.comp");
+    mortonCompactPipeline = LoadComputePipeline(device, "mortoncompact.comp");
+    dirtyPipeline = LoadComputePipeline(device, "dirty.comp");
+    mortonDirtyPipeline = LoadComputePipeline(device, "mortondirty.comp");
+    greedyPipeline = LoadComputePipeline(device, "greedy.comp");
+    mortonGreedyPipeline = LoadComputePipeline(device, "mortongreedy.comp");
+    occupancyPipeline = LoadComputePipeline(device, "occupancy.comp");
+    mortonOccupancyPipeline = LoadComputePipeline(device, "mortonoccupancy.comp");
+    superbricksPipeline = LoadComputePipeline(device, "superbricks.comp");
+    bool variants =
+        LoadVariants(computePipelines, "automata", false) &&
+        LoadVariants(sparsePipelines, "sparse", false) &&
+        LoadVariants(temporalPipelines, "temporal", true) &&
+        LoadVariants(packedPipelines, "packed", true) &&
+        LoadVariants(mortonPipelines, "morton", true);
+    if (!mortonInitPipeline || !ensembleInitPipeline || !ensemblePipeline || !statsPipeline || !mortonStatsPipeline || !boundsPipeline ||
+        !compactPipeline || !mortonCompactPipeline || !dirtyPipeline || !mortonDirtyPipeline || !greedyPipeline || !mortonGreedyPipeline ||
+        !occupancyPipeline || !mortonOccupancyPipeline || !superbricksPipeline ||
+        !initPipeline || !sumPipeline || !separablePipeline || !bricksPipeline || !haloPipeline || !packPipeline || !variants)
     {
-        SDL_Log("Failed to acquire command buffer: %s", SDL_GetError());
+        SDL_Log("Failed to create pipeline(s): %s", SDL_GetError());
         return false;
     }
-    SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
-    if (!copyPass)
+    if (subgroups)
     {
-        SDL_Log("Failed to begin copy pass: %s", SDL_GetError());
-        return false;
+        if (!LoadVariants(subgroupPipelines, "subgroup", false))
+        {
+            SDL_Log("Failed to create subgroup pipeline, falling back: %s", SDL_GetError());
+            subgroups = false;
+        }
+    }
+    if (tiled)
+    {
+        if (!LoadVariants(tiledPipelines, "tiled", false))
+        {
+            SDL_Log("Failed to create tiled pipeline, falling back to automata: %s", SDL_GetError());
+            tiled = false;
+        }
     }
+    return true;
+}
+
+static bool CreateResources()
+{
     for (int i = 0; i < FRAMES; i++)
     {
         SDL_GPUTextureCreateInfo info{};
@@ -182,9 +408,10 @@ static bool CreateResources()
             SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ |
             SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE |
             SDL_GPU_TEXTUREUSAGE_GRAPHICS_STORAGE_READ;
-        info.width = BOUNDS;
-        info.height = BOUNDS;
-        info.layer_count_or_depth = BOUNDS;
+        /* with a one cell halo */
+        info.width = gridWidth + 2;
+        info.height = gridHeight + 2;
+        info.layer_count_or_depth = gridDepth + 2;
         info.num_levels = 1;
         textures[i] = SDL_CreateGPUTexture(device, &info);
         if (!textures[i])
@@ -193,328 +420,1568 @@ static bool CreateResources()
             return false;
         }
     }
+    for (int i = 0; i < 2; i++)
     {
-        float vertices[36 * 3] =
-        {
-           -0.5f,-0.5f, 0.5f,
-            0.5f,-0.5f, 0.5f,
-            0.5f, 0.5f, 0.5f,
-           -0.5f,-0.5f, 0.5f,
-            0.5f, 0.5f, 0.5f,
-           -0.5f, 0.5f, 0.5f,
-           -0.5f,-0.5f,-0.5f,
-            0.5f, 0.5f,-0.5f,
-            0.5f,-0.5f,-0.5f,
-           -0.5f,-0.5f,-0.5f,
-           -0.5f, 0.5f,-0.5f,
-            0.5f, 0.5f,-0.5f,
-           -0.5f,-0.5f,-0.5f,
-           -0.5f,-0.5f, 0.5f,
-           -0.5f, 0.5f, 0.5f,
-           -0.5f,-0.5f,-0.5f,
-           -0.5f, 0.5f, 0.5f,
-           -0.5f, 0.5f,-0.5f,
-            0.5f,-0.5f,-0.5f,
-            0.5f, 0.5f, 0.5f,
-            0.5f,-0.5f, 0.5f,
-            0.5f,-0.5f,-0.5f,
-            0.5f, 0.5f,-0.5f,
-            0.5f, 0.5f, 0.5f,
-           -0.5f, 0.5f,-0.5f,
-           -0.5f, 0.5f, 0.5f,
-            0.5f, 0.5f, 0.5f,
-           -0.5f, 0.5f,-0.5f,
-            0.5f, 0.5f, 0.5f,
-            0.5f, 0.5f,-0.5f,
-           -0.5f,-0.5f,-0.5f,
-            0.5f,-0.5f, 0.5f,
-           -0.5f,-0.5f, 0.5f,
-           -0.5f,-0.5f,-0.5f,
-            0.5f,-0.5f,-0.5f,
-            0.5f,-0.5f, 0.5f,
-        };
-        SDL_GPUTransferBuffer* transferBuffer;
-        {
-            SDL_GPUTransferBufferCreateInfo info{};
-            info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-            info.size = sizeof(vertices);
-            transferBuffer = SDL_CreateGPUTransferBuffer(device, &info);
-            if (!transferBuffer)
-            {
-                SDL_Log("Failed to create transfer buffer: %s", SDL_GetError());
-                return false;
-            }
-        }
-        void* data = SDL_MapGPUTransferBuffer(device, transferBuffer, false);
-        if (!data)
+        SDL_GPUTextureCreateInfo info{};
+        info.type = SDL_GPU_TEXTURETYPE_3D;
+        info.format = SDL_GPU_TEXTUREFORMAT_R8_UINT;
+        info.usage =
+            SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ |
+            SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE;
+        /* with a one cell halo */
+        info.width = gridWidth + 2;
+        info.height = gridHeight + 2;
+        info.layer_count_or_depth = gridDepth + 2;
+        info.num_levels = 1;
+        sumTextures[i] = SDL_CreateGPUTexture(device, &info);
+        if (!sumTextures[i])
         {
-            SDL_Log("Failed to map transfer buffer: %s", SDL_GetError());
+            SDL_Log("Failed to create texture: %s", SDL_GetError());
             return false;
         }
+    }
+    for (int i = 0; i < FRAMES; i++)
+    {
+        SDL_GPUTextureCreateInfo info{};
+        info.type = SDL_GPU_TEXTURETYPE_3D;
+        info.format = SDL_GPU_TEXTUREFORMAT_R8_UINT;
+        info.usage =
+            SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ |
+            SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE |
+            SDL_GPU_TEXTUREUSAGE_GRAPHICS_STORAGE_READ;
+        info.width = bricksX;
+        info.height = bricksY;
+        info.layer_count_or_depth = bricksZ;
+        info.num_levels = 1;
+        brickTextures[i] = SDL_CreateGPUTexture(device, &info);
+        info.width = (bricksX + THREADS - 1) / THREADS;
+        info.height = (bricksY + THREADS - 1) / THREADS;
+        info.layer_count_or_depth = (bricksZ + THREADS - 1) / THREADS;
+        superbrickTextures[i] = SDL_CreateGPUTexture(device, &info);
+        if (!brickTextures[i] || !superbrickTextures[i])
         {
-            SDL_GPUBufferCreateInfo info{};
-            info.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
-            info.size = sizeof(vertices);
-            vertexBuffer = SDL_CreateGPUBuffer(device, &info);
-            if (!vertexBuffer)
-            {
-                SDL_Log("Failed to create buffer: %s", SDL_GetError());
-                return false;
-            }
+            SDL_Log("Failed to create texture: %s", SDL_GetError());
+            return false;
         }
-        std::memcpy(data, vertices, sizeof(vertices));
-        SDL_GPUTransferBufferLocation location{};
-        SDL_GPUBufferRegion region{};
-        location.transfer_buffer = transferBuffer;
-        region.buffer = vertexBuffer;
-        region.size = sizeof(vertices);
-        SDL_UploadToGPUBuffer(copyPass, &location, &region, false);
-        SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
     }
+    for (int i = 0; i < FRAMES; i++)
     {
-        SDL_GPUTransferBuffer* transferBuffer;
+        SDL_GPUTextureCreateInfo info{};
+        info.type = SDL_GPU_TEXTURETYPE_3D;
+        info.format = SDL_GPU_TEXTUREFORMAT_R32_UINT;
+        info.usage =
+            SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ |
+            SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE |
+            SDL_GPU_TEXTUREUSAGE_GRAPHICS_STORAGE_READ;
+        info.width = (gridWidth + 31) / 32;
+        info.height = gridHeight;
+        info.layer_count_or_depth = gridDepth;
+        info.num_levels = 1;
+        bitTextures[i] = SDL_CreateGPUTexture(device, &info);
+        if (!bitTextures[i])
         {
-            SDL_GPUTransferBufferCreateInfo info{};
-            info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-            info.size = BOUNDS * BOUNDS * BOUNDS * sizeof(uint32_t);
-            transferBuffer = SDL_CreateGPUTransferBuffer(device, &info);
-            if (!transferBuffer)
-            {
-                SDL_Log("Failed to create transfer buffer: %s", SDL_GetError());
-                return 1;
-            }
+            SDL_Log("Failed to create texture: %s", SDL_GetError());
+            return false;
         }
-        uint32_t* data = static_cast<uint32_t*>(SDL_MapGPUTransferBuffer(device, transferBuffer, false));
-        if (!data)
+    }
+    {
+        SDL_GPUBufferCreateInfo info{};
+        info.usage =
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ |
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+        /* a count for each slot followed by every slot */
+        info.size = (FRAMES + FRAMES * bricksX * bricksY * bricksZ) * sizeof(uint32_t);
+        bricksBuffer = SDL_CreateGPUBuffer(device, &info);
+        info.size = FRAMES * bricksX * bricksY * bricksZ * sizeof(uint32_t);
+        changedBuffer = SDL_CreateGPUBuffer(device, &info);
+        info.usage |= SDL_GPU_BUFFERUSAGE_INDIRECT;
+        info.size = FRAMES * 3 * sizeof(uint32_t);
+        argsBuffer = SDL_CreateGPUBuffer(device, &info);
+        /* dispatch arguments and origin followed by a box per frame */
+        info.size = (3 + 3 + FRAMES * 6) * sizeof(uint32_t);
+        boundsBuffer = SDL_CreateGPUBuffer(device, &info);
+        if (!bricksBuffer || !changedBuffer || !argsBuffer || !boundsBuffer)
         {
-            SDL_Log("Failed to map transfer buffer: %s", SDL_GetError());
+            SDL_Log("Failed to create buffer: %s", SDL_GetError());
             return false;
         }
+    }
+    for (int i = 0; i < FRAMES; i++)
+    {
+        SDL_GPUBufferCreateInfo info{};
+        info.usage =
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ |
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE |
+            SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ;
+        info.size = static_cast<uint64_t>(bricksX) * bricksY * bricksZ * THREADS * THREADS * THREADS;
+        cellBuffers[i] = SDL_CreateGPUBuffer(device, &info);
+        if (!cellBuffers[i])
         {
-            SDL_GPUBufferCreateInfo info{};
-            info.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
-            info.size = BOUNDS * BOUNDS * BOUNDS * sizeof(uint32_t);
-            instanceBuffer = SDL_CreateGPUBuffer(device, &info);
-            if (!instanceBuffer)
-            {
-                SDL_Log("Failed to create buffer: %s", SDL_GetError());
-                return false;
-            }
+            SDL_Log("Failed to create buffer: %s", SDL_GetError());
+            return false;
         }
-        uint32_t i = 0;
-        for (int x = 0; x < BOUNDS; x++)
-        for (int y = 0; y < BOUNDS; y++)
-        for (int z = 0; z < BOUNDS; z++)
-        {
-            data[i] = 0;
-            data[i] |= x << 0;
-            data[i] |= y << 10;
-            data[i] |= z << 20;
-            i++;
-        }
-        SDL_GPUTransferBufferLocation location{};
-        SDL_GPUBufferRegion region{};
-        location.transfer_buffer = transferBuffer;
-        region.buffer = instanceBuffer;
-        region.size = BOUNDS * BOUNDS * BOUNDS * sizeof(uint32_t);
-        SDL_UploadToGPUBuffer(copyPass, &location, &region, false);
-        SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
     }
-    SDL_EndGPUCopyPass(copyPass);
-    SDL_SubmitGPUCommandBuffer(commandBuffer);
-    return true;
-}
-
-static void DrawImGui()
-{
-    ImGui_ImplSDLGPU3_NewFrame();
-    ImGui::NewFrame();
-    ImGui::Begin("Settings");
-    imguiFocused = ImGui::IsWindowFocused();
-    if (ImGui::Button("Reset"))
     {
-        rules.seed = std::rand() % RAND_MAX;
-        rules.frame = 0;
+        SDL_GPUBufferCreateInfo info{};
+        info.usage =
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ |
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+        info.size = sizeof(Stats);
+        statsBuffer = SDL_CreateGPUBuffer(device, &info);
+        if (!statsBuffer)
+        {
+            SDL_Log("Failed to create buffer: %s", SDL_GetError());
+            return false;
+        }
     }
-    ImGui::SliderFloat("Speed", &delay, 0.0f, 1000.0f);
-    ImGui::Text("Survive");
-    for (int i = 1; i < 27; i++)
+    for (int i = 0; i < READBACKS; i++)
     {
-        bool bit = (rules.surviveMask >> i) & 1;
-        if (i % 7 == 0)
+        SDL_GPUTransferBufferCreateInfo info{};
+        info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD;
+        info.size = sizeof(Stats);
+        statsTransferBuffers[i] = SDL_CreateGPUTransferBuffer(device, &info);
+        if (!statsTransferBuffers[i])
         {
-            ImGui::NewLine();
+            SDL_Log("Failed to create transfer buffer: %s", SDL_GetError());
+            return false;
         }
-        ImGui::PushID(i);
-        if (ImGui::Checkbox("", &bit))
+    }
+    if (ensemble > 0)
+    {
+        for (int i = 0; i < FRAMES; i++)
         {
-            if (bit)
-            {
-                rules.surviveMask |= (1 << i);
-            }
-            else
+            SDL_GPUTextureCreateInfo info{};
+            info.type = SDL_GPU_TEXTURETYPE_3D;
+            info.format = SDL_GPU_TEXTUREFORMAT_R8_UINT;
+            info.usage =
+                SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ |
+                SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE;
+            /* without a halo since members wrap or clip themselves */
+            info.width = gridWidth;
+            info.height = gridHeight;
+            info.layer_count_or_depth = gridDepth * ensemble;
+            info.num_levels = 1;
+            ensembleTextures[i] = SDL_CreateGPUTexture(device, &info);
+            if (!ensembleTextures[i])
             {
-                rules.surviveMask &= ~(1 << i);
+                SDL_Log("Failed to create texture: %s", SDL_GetError());
+                return false;
             }
         }
-        ImGui::SameLine();
-        ImGui::Text("%02d", i);
-        ImGui::SameLine();
-        ImGui::PopID();
+        SDL_GPUBufferCreateInfo info{};
+        info.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ;
+        info.size = ensemble * sizeof(Rules);
+        membersBuffer = SDL_CreateGPUBuffer(device, &info);
+        if (!membersBuffer)
+        {
+            SDL_Log("Failed to create buffer: %s", SDL_GetError());
+            return false;
+        }
+        SDL_GPUTransferBufferCreateInfo transferInfo{};
+        transferInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+        transferInfo.size = ensemble * sizeof(Rules);
+        membersTransferBuffer = SDL_CreateGPUTransferBuffer(device, &transferInfo);
+        if (!membersTransferBuffer)
+        {
+            SDL_Log("Failed to create transfer buffer: %s", SDL_GetError());
+            return false;
+        }
     }
-    ImGui::NewLine();
-    ImGui::Text("Birth");
-    for (int i = 1; i < 27; i++)
     {
-        bool bit = (rules.birthMask >> i) & 1;
-        if (i % 7 == 0)
+        SDL_GPUBufferCreateInfo info{};
+        info.usage =
+            SDL_GPU_BUFFERUSAGE_INDIRECT |
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ |
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+        info.size = sizeof(SDL_GPUIndirectDrawCommand);
+        drawBuffer = SDL_CreateGPUBuffer(device, &info);
+        if (!drawBuffer)
         {
-            ImGui::NewLine();
+            SDL_Log("Failed to create buffer: %s", SDL_GetError());
+            return false;
         }
-        ImGui::PushID(32 + i);
-        if (ImGui::Checkbox("", &bit))
+    }
+    {
+        /* kept mapped once so that every draw resets the instance count from it */
+        SDL_GPUTransferBufferCreateInfo info{};
+        info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+        info.size = sizeof(SDL_GPUIndirectDrawCommand);
+        drawTransferBuffer = SDL_CreateGPUTransferBuffer(device, &info);
+        if (!drawTransferBuffer)
         {
-            if (bit)
-            {
-                rules.birthMask |= (1 << i);
-            }
-            else
-            {
-                rules.birthMask &= ~(1 << i);
-            }
+            SDL_Log("Failed to create transfer buffer: %s", SDL_GetError());
+            return false;
         }
-        ImGui::SameLine();
-        ImGui::Text("%02d", i);
-        ImGui::SameLine();
-        ImGui::PopID();
+        SDL_GPUIndirectDrawCommand* data = static_cast<SDL_GPUIndirectDrawCommand*>(
+            SDL_MapGPUTransferBuffer(device, drawTransferBuffer, false));
+        if (!data)
+        {
+            SDL_Log("Failed to map transfer buffer: %s", SDL_GetError());
+            return false;
+        }
+        *data = SDL_GPUIndirectDrawCommand{};
+        data->num_vertices = 36;
+        SDL_UnmapGPUTransferBuffer(device, drawTransferBuffer);
     }
-    ImGui::NewLine();
-    int life = rules.life;
-    int neighborhood = rules.neighborhood;
-    ImGui::SliderInt("Life", &life, 1, 64);
-    ImGui::Text("Neighborhood");
-    ImGui::RadioButton("Moore", &neighborhood, 0);
-    ImGui::RadioButton("Von Neumann", &neighborhood, 1);
-    rules.life = life;
-    rules.neighborhood = neighborhood;
-    ImGui::End();
-    ImGui::Render();
+    return true;
 }
 
-static void Draw()
+/* creates the faces while they are drawn, since they take eight bytes per cell */
+static bool CreateFaces()
 {
-    SDL_WaitForGPUSwapchain(device, window);
-    SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(device);
-    if (!commandBuffer)
+    uint64_t size = static_cast<uint64_t>(gridWidth) * gridHeight * gridDepth * sizeof(uint32_t) * 2;
+    if (size > UINT32_MAX)
     {
-        SDL_Log("Failed to acquire command buffer: %s", SDL_GetError());
-        return;
+        SDL_Log("Too many cells for faces: %dx%dx%d", gridWidth, gridHeight, gridDepth);
+        return false;
     }
-    SDL_GPUTexture* texture;
-    uint32_t width;
-    uint32_t height;
-    if (!SDL_AcquireGPUSwapchainTexture(commandBuffer, window, &texture, &width, &height))
+    if (!faceBuffer)
     {
-        SDL_Log("Failed to acquire swapchain texture: %s", SDL_GetError());
-        SDL_CancelGPUCommandBuffer(commandBuffer);
-        return;
-    }
-    if (!texture || !width || !height)
+        SDL_GPUBufferCreateInfo info{};
+        info.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+        info.size = size;
+        faceBuffer = SDL_CreateGPUBuffer(device, &info);
+        if (!faceBuffer)
+        {
+            SDL_Log("Failed to create buffer: %s", SDL_GetError());
+            return false;
+        }
+    }
+    return true;
+}
+
+/* fills a new buffer with zeros, submitted on its own ahead of the frames that read it */
+static bool ClearBuffer(SDL_GPUBuffer* buffer, uint32_t size)
+{
+    SDL_GPUTransferBufferCreateInfo info{};
+    info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+    info.size = size;
+    SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(device, &info);
+    if (!transferBuffer)
+    {
+        SDL_Log("Failed to create transfer buffer: %s", SDL_GetError());
+        return false;
+    }
+    void* data = SDL_MapGPUTransferBuffer(device, transferBuffer, false);
+    if (!data)
+    {
+        SDL_Log("Failed to map transfer buffer: %s", SDL_GetError());
+        SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+        return false;
+    }
+    std::memset(data, 0, size);
+    SDL_UnmapGPUTransferBuffer(device, transferBuffer);
+    SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(device);
+    if (!commandBuffer)
+    {
+        SDL_Log("Failed to acquire command buffer: %s", SDL_GetError());
+        SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+        return false;
+    }
+    SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+    if (!copyPass)
+    {
+        SDL_Log("Failed to begin copy pass: %s", SDL_GetError());
+        SDL_CancelGPUCommandBuffer(commandBuffer);
+        SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+        return false;
+    }
+    SDL_GPUTransferBufferLocation location{};
+    SDL_GPUBufferRegion region{};
+    location.transfer_buffer = transferBuffer;
+    region.buffer = buffer;
+    region.size = size;
+    SDL_UploadToGPUBuffer(copyPass, &location, &region, false);
+    SDL_EndGPUCopyPass(copyPass);
+    /* released once the upload finishes */
+    SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+    if (!SDL_SubmitGPUCommandBuffer(commandBuffer))
+    {
+        SDL_Log("Failed to submit command buffer: %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+/* creates the chunks on first use, since their quads take more memory than the cells */
+static bool CreateChunks()
+{
+    uint64_t chunks = static_cast<uint64_t>(bricksX) * bricksY * bricksZ;
+    if (chunks * MESH_QUADS * sizeof(uint32_t) * 2 > UINT32_MAX)
+    {
+        SDL_Log("Too many chunks to mesh: %d", static_cast<int>(chunks));
+        return false;
+    }
+    if (!chunkBuffer)
+    {
+        SDL_GPUBufferCreateInfo info{};
+        info.usage =
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ |
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+        info.size = chunks * sizeof(uint32_t) * 2;
+        chunkBuffer = SDL_CreateGPUBuffer(device, &info);
+        if (!chunkBuffer)
+        {
+            SDL_Log("Failed to create buffer: %s", SDL_GetError());
+            return false;
+        }
+        /* no chunk has been stamped by a step yet */
+        if (!ClearBuffer(chunkBuffer, info.size))
+        {
+            return false;
+        }
+    }
+    if (!quadBuffer)
+    {
+        SDL_GPUBufferCreateInfo info{};
+        info.usage = SDL_GPU_BUFFERUSAGE_VERTEX | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+        info.size = chunks * MESH_QUADS * sizeof(uint32_t) * 2;
+        quadBuffer = SDL_CreateGPUBuffer(device, &info);
+        if (!quadBuffer)
+        {
+            SDL_Log("Failed to create buffer: %s", SDL_GetError());
+            return false;
+        }
+    }
+    if (!chunkDrawBuffer)
+    {
+        SDL_GPUBufferCreateInfo info{};
+        info.usage = SDL_GPU_BUFFERUSAGE_INDIRECT | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+        info.size = chunks * sizeof(SDL_GPUIndirectDrawCommand);
+        chunkDrawBuffer = SDL_CreateGPUBuffer(device, &info);
+        if (!chunkDrawBuffer)
+        {
+            SDL_Log("Failed to create buffer: %s", SDL_GetError());
+            return false;
+        }
+    }
+    return true;
+}
+
+/* downloads the newest cells of one member on their own, x-major without a halo */
+static bool ReadMember(int index, std::vector<uint8_t>& cells)
+{
+    uint32_t size = static_cast<uint64_t>(gridWidth) * gridHeight * gridDepth;
+    SDL_GPUTransferBufferCreateInfo info{};
+    info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD;
+    info.size = size;
+    SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(device, &info);
+    if (!transferBuffer)
+    {
+        SDL_Log("Failed to create transfer buffer: %s", SDL_GetError());
+        return false;
+    }
+    SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(device);
+    if (!commandBuffer)
+    {
+        SDL_Log("Failed to acquire command buffer: %s", SDL_GetError());
+        SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+        return false;
+    }
+    SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+    if (!copyPass)
+    {
+        SDL_Log("Failed to begin copy pass: %s", SDL_GetError());
+        SDL_CancelGPUCommandBuffer(commandBuffer);
+        SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+        return false;
+    }
+    SDL_GPUTextureRegion region{};
+    region.texture = ensembleTextures[readFrame];
+    region.z = index * gridDepth;
+    region.w = gridWidth;
+    region.h = gridHeight;
+    region.d = gridDepth;
+    SDL_GPUTextureTransferInfo transferInfo{};
+    transferInfo.transfer_buffer = transferBuffer;
+    transferInfo.pixels_per_row = gridWidth;
+    transferInfo.rows_per_layer = gridHeight;
+    SDL_DownloadFromGPUTexture(copyPass, &region, &transferInfo);
+    SDL_EndGPUCopyPass(copyPass);
+    SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+    if (!fence)
+    {
+        SDL_Log("Failed to submit command buffer: %s", SDL_GetError());
+        SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+        return false;
+    }
+    SDL_WaitForGPUFences(device, true, &fence, 1);
+    SDL_ReleaseGPUFence(device, fence);
+    void* data = SDL_MapGPUTransferBuffer(device, transferBuffer, false);
+    if (!data)
+    {
+        SDL_Log("Failed to map transfer buffer: %s", SDL_GetError());
+        SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+        return false;
+    }
+    cells.resize(size);
+    std::memcpy(cells.data(), data, size);
+    SDL_UnmapGPUTransferBuffer(device, transferBuffer);
+    SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+    return true;
+}
+
+/* reads a survive and birth mask per member and line, then optionally the life, neighborhood and boundary, skipping
+ * blank lines and those starting with # */
+static bool LoadMemberRules(const char* path)
+{
+    std::ifstream file(path);
+    if (file.fail())
+    {
+        SDL_Log("Failed to open ensemble rules: %s", path);
+        return false;
+    }
+    std::string line;
+    for (int number = 1; std::getline(file, line); number++)
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        Rules member;
+        int values[5] = {0, 0, static_cast<int>(member.life), static_cast<int>(member.neighborhood), static_cast<int>(member.boundary)};
+        int count = std::sscanf(line.data(), "%i %i %i %i %i", &values[0], &values[1], &values[2], &values[3], &values[4]);
+        if (count < 2 || values[2] < 1 || values[2] > 255 || values[3] < 0 || values[3] > 1 || values[4] < 0 || values[4] > 1)
+        {
+            SDL_Log("Bad ensemble rules on line %d: %s", number, line.data());
+            return false;
+        }
+        member.surviveMask = values[0];
+        member.birthMask = values[1];
+        member.life = values[2];
+        member.neighborhood = values[3];
+        member.boundary = values[4];
+        memberRules.push_back(member);
+    }
+    return true;
+}
+
+static void ReadMembers()
+{
+    std::vector<uint8_t> cells;
+    for (int i = 0; i < ensemble; i++)
+    {
+        if (!ReadMember(i, cells))
+        {
+            return;
+        }
+        int population = static_cast<int>(std::count_if(cells.begin(), cells.end(), [](uint8_t cell) { return cell > 0; }));
+        SDL_Log("Member %d: survive %x, birth %x, life %u, seed %u, %d alive",
+            i, members[i].surviveMask, members[i].birthMask, members[i].life, members[i].seed, population);
+    }
+}
+
+static void DrawImGui()
+{
+    ImGui_ImplSDLGPU3_NewFrame();
+    ImGui::NewFrame();
+    ImGui::Begin("Settings");
+    imguiFocused = ImGui::IsWindowFocused();
+    if (ImGui::Button("Reset"))
+    {
+        rules.seed = std::rand() % RAND_MAX;
+        rules.frame = 0;
+    }
+    ImGui::SliderFloat("Speed", &delay, 0.0f, 1000.0f);
+    if (delay == 0.0f)
+    {
+        ImGui::Text("Turbo: %d steps per batch", turboSteps);
+    }
+    ImGui::Text("Render");
+    int oldRender = render;
+    ImGui::RadioButton("Faces", &render, RENDER_FACES);
+    ImGui::RadioButton("Greedy", &render, RENDER_GREEDY);
+    ImGui::RadioButton("March", &render, RENDER_MARCH);
+    if (render != oldRender && render == RENDER_FACES && !CreateFaces())
+    {
+        render = oldRender;
+    }
+    if (render != oldRender && render == RENDER_GREEDY)
+    {
+        /* chunks were not stamped while faces were drawn and the quads are new, so the first mesh is full */
+        if (CreateChunks())
+        {
+            trackedSteps = steps;
+            meshedSteps = 0;
+        }
+        else
+        {
+            render = oldRender;
+        }
+    }
+    if (render != oldRender && oldRender == RENDER_FACES)
+    {
+        SDL_ReleaseGPUBuffer(device, faceBuffer);
+        faceBuffer = nullptr;
+    }
+    if (render != oldRender && oldRender == RENDER_GREEDY)
+    {
+        SDL_ReleaseGPUBuffer(device, chunkBuffer);
+        SDL_ReleaseGPUBuffer(device, quadBuffer);
+        SDL_ReleaseGPUBuffer(device, chunkDrawBuffer);
+        chunkBuffer = nullptr;
+        quadBuffer = nullptr;
+        chunkDrawBuffer = nullptr;
+    }
+    ImGui::Text("Stats");
+    if (statsValid)
+    {
+        ImGui::Text("Generation %u: %u alive", statsFrame, stats.alive);
+        ImGui::Text("Births %u, deaths %u", stats.births, stats.deaths);
+        if (stats.alive > 0)
+        {
+            ImGui::Text("Bounds (%u, %u, %u) to (%u, %u, %u)",
+                stats.minimum[0], stats.minimum[1], stats.minimum[2],
+                stats.maximum[0], stats.maximum[1], stats.maximum[2]);
+        }
+        float ages[STATS_AGES];
+        for (int i = 0; i < STATS_AGES; i++)
+        {
+            ages[i] = static_cast<float>(stats.ages[i]);
+        }
+        ImGui::PlotHistogram("Ages", ages, std::min<int>(rules.life, STATS_AGES));
+    }
+    ImGui::Text("Survive");
+    for (int i = 1; i < 27; i++)
+    {
+        bool bit = (rules.surviveMask >> i) & 1;
+        if (i % 7 == 0)
+        {
+            ImGui::NewLine();
+        }
+        ImGui::PushID(i);
+        if (ImGui::Checkbox("", &bit))
+        {
+            if (bit)
+            {
+                rules.surviveMask |= (1 << i);
+            }
+            else
+            {
+                rules.surviveMask &= ~(1 << i);
+            }
+        }
+        ImGui::SameLine();
+        ImGui::Text("%02d", i);
+        ImGui::SameLine();
+        ImGui::PopID();
+    }
+    ImGui::NewLine();
+    ImGui::Text("Birth");
+    for (int i = 1; i < 27; i++)
+    {
+        bool bit = (rules.birthMask >> i) & 1;
+        if (i % 7 == 0)
+        {
+            ImGui::NewLine();
+        }
+        ImGui::PushID(32 + i);
+        if (ImGui::Checkbox("", &bit))
+        {
+            if (bit)
+            {
+                rules.birthMask |= (1 << i);
+            }
+            else
+            {
+                rules.birthMask &= ~(1 << i);
+            }
+        }
+        ImGui::SameLine();
+        ImGui::Text("%02d", i);
+        ImGui::SameLine();
+        ImGui::PopID();
+    }
+    ImGui::NewLine();
+    int life = rules.life;
+    int neighborhood = rules.neighborhood;
+    ImGui::SliderInt("Life", &life, 1, 64);
+    ImGui::Text("Neighborhood");
+    ImGui::RadioButton("Moore", &neighborhood, 0);
+    ImGui::RadioButton("Von Neumann", &neighborhood, 1);
+    ImGui::Text("Boundary");
+    int boundary = rules.boundary;
+    ImGui::RadioButton("Dead", &boundary, BOUNDARY_DEAD);
+    ImGui::RadioButton("Periodic", &boundary, BOUNDARY_PERIODIC);
+    rules.boundary = boundary;
+    if (ensemble > 0)
+    {
+        /* the rules above belong to the selected member */
+        int selected = member;
+        ImGui::SliderInt("Member", &selected, 0, ensemble - 1);
+        if (selected != member)
+        {
+            uint32_t frame = rules.frame;
+            members[member] = rules;
+            rules = members[selected];
+            rules.frame = frame;
+            member = selected;
+        }
+        if (ImGui::Button("Read"))
+        {
+            ReadMembers();
+        }
+    }
+    /* ensembles always step directly in their own texture */
+    ImGui::BeginDisabled(ensemble > 0);
+    ImGui::Text("Layout");
+    int oldLayout = layout;
+    ImGui::RadioButton("Texture", &layout, LAYOUT_TEXTURE);
+    ImGui::RadioButton("Morton", &layout, LAYOUT_MORTON);
+    if (layout != oldLayout)
+    {
+        /* the layouts do not share cells so switching reseeds */
+        rules.frame = 0;
+    }
+    /* the buffer layout only counts directly */
+    ImGui::BeginDisabled(layout == LAYOUT_MORTON);
+    ImGui::Text("Counting");
+    ImGui::RadioButton("Direct", &counting, COUNTING_DIRECT);
+    ImGui::RadioButton("Separable", &counting, COUNTING_SEPARABLE);
+    ImGui::Checkbox("Sparse", &sparse);
+    ImGui::Checkbox("Shrink", &shrink);
+    ImGui::Text("Storage");
+    ImGui::RadioButton("Bytes", &storage, STORAGE_BYTES);
+    ImGui::RadioButton("Bits", &storage, STORAGE_BITS);
+    ImGui::SliderInt("Generations", &temporal, 1, TEMPORAL);
+    ImGui::EndDisabled();
+    ImGui::EndDisabled();
+    rules.life = life;
+    rules.neighborhood = neighborhood;
+    ImGui::End();
+    ImGui::Render();
+}
+
+/* writes the live cells of the drawn frame with an exposed face and their count into the indirect draw */
+static bool Compact(SDL_GPUCommandBuffer* commandBuffer)
+{
+    SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+    if (!copyPass)
+    {
+        SDL_Log("Failed to begin copy pass: %s", SDL_GetError());
+        return false;
+    }
+    SDL_GPUTransferBufferLocation location{};
+    SDL_GPUBufferRegion region{};
+    location.transfer_buffer = drawTransferBuffer;
+    region.buffer = drawBuffer;
+    region.size = sizeof(SDL_GPUIndirectDrawCommand);
+    SDL_UploadToGPUBuffer(copyPass, &location, &region, false);
+    SDL_EndGPUCopyPass(copyPass);
+    SDL_GPUStorageBufferReadWriteBinding bufferBindings[2]{};
+    bufferBindings[0].buffer = faceBuffer;
+    bufferBindings[1].buffer = drawBuffer;
+    SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, nullptr, 0, bufferBindings, 2);
+    if (!computePass)
+    {
+        SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+        return false;
+    }
+    if (layout == LAYOUT_MORTON)
+    {
+        int32_t size[4] = {gridWidth, gridHeight, gridDepth, 0};
+        SDL_BindGPUComputePipeline(computePass, mortonCompactPipeline);
+        SDL_BindGPUComputeStorageTextures(computePass, 0, &brickTextures[drawFrame], 1);
+        SDL_BindGPUComputeStorageBuffers(computePass, 0, &cellBuffers[drawFrame], 1);
+        SDL_PushGPUComputeUniformData(commandBuffer, 0, size, sizeof(size));
+    }
+    else
+    {
+        SDL_GPUTexture* inTextures[2] = {textures[drawFrame], brickTextures[drawFrame]};
+        SDL_BindGPUComputePipeline(computePass, compactPipeline);
+        SDL_BindGPUComputeStorageTextures(computePass, 0, inTextures, 2);
+    }
+    SDL_DispatchGPUCompute(computePass, bricksX, bricksY, bricksZ);
+    SDL_EndGPUComputePass(computePass);
+    return true;
+}
+
+/* greedily remeshes the chunks that changed after the frame meshed before, or all of them when that one is older than the stamps */
+static bool Mesh(SDL_GPUCommandBuffer* commandBuffer)
+{
+    SDL_GPUStorageBufferReadWriteBinding bufferBindings[2]{};
+    bufferBindings[0].buffer = quadBuffer;
+    bufferBindings[1].buffer = chunkDrawBuffer;
+    SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, nullptr, 0, bufferBindings, 2);
+    if (!computePass)
+    {
+        SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+        return false;
+    }
+    uint32_t uniforms[4] = {frameSteps[drawFrame], meshedSteps, meshedSteps < trackedSteps, 0};
+    if (layout == LAYOUT_MORTON)
+    {
+        SDL_GPUBuffer* inBuffers[2] = {cellBuffers[drawFrame], chunkBuffer};
+        int32_t size[4] = {gridWidth, gridHeight, gridDepth, 0};
+        SDL_BindGPUComputePipeline(computePass, mortonGreedyPipeline);
+        SDL_BindGPUComputeStorageBuffers(computePass, 0, inBuffers, 2);
+        SDL_PushGPUComputeUniformData(commandBuffer, 1, size, sizeof(size));
+    }
+    else
+    {
+        SDL_BindGPUComputePipeline(computePass, greedyPipeline);
+        SDL_BindGPUComputeStorageTextures(computePass, 0, &textures[drawFrame], 1);
+        SDL_BindGPUComputeStorageBuffers(computePass, 0, &chunkBuffer, 1);
+    }
+    SDL_PushGPUComputeUniformData(commandBuffer, 0, uniforms, sizeof(uniforms));
+    SDL_DispatchGPUCompute(computePass, bricksX, bricksY, bricksZ);
+    SDL_EndGPUComputePass(computePass);
+    meshedSteps = frameSteps[drawFrame];
+    return true;
+}
+
+static void Draw()
+{
+    SDL_WaitForGPUSwapchain(device, window);
+    SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(device);
+    if (!commandBuffer)
+    {
+        SDL_Log("Failed to acquire command buffer: %s", SDL_GetError());
+        return;
+    }
+    SDL_GPUTexture* texture;
+    uint32_t width;
+    uint32_t height;
+    if (!SDL_AcquireGPUSwapchainTexture(commandBuffer, window, &texture, &width, &height))
+    {
+        SDL_Log("Failed to acquire swapchain texture: %s", SDL_GetError());
+        SDL_CancelGPUCommandBuffer(commandBuffer);
+        return;
+    }
+    if (!texture || !width || !height)
+    {
+        /* happens on minimize */
+        SDL_SubmitGPUCommandBuffer(commandBuffer);
+        return;
+    }
+    if (width != depthTextureWidth || height != depthTextureHeight)
+    {
+        SDL_ReleaseGPUTexture(device, depthTexture);
+        SDL_GPUTextureCreateInfo info{};
+        info.type = SDL_GPU_TEXTURETYPE_2D;
+        info.format = SDL_GPU_TEXTUREFORMAT_D32_FLOAT;
+        info.usage = SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET;
+        info.width = width;
+        info.height = height;
+        info.layer_count_or_depth = 1;
+        info.num_levels = 1;
+        info.props = SDL_CreateProperties();
+        SDL_SetFloatProperty(info.props, SDL_PROP_GPU_TEXTURE_CREATE_D3D12_CLEAR_DEPTH_FLOAT, 1.0f);
+        depthTexture = SDL_CreateGPUTexture(device, &info);
+        SDL_DestroyProperties(info.props);
+        if (!depthTexture)
+        {
+            SDL_Log("Failed to create texture: %s", SDL_GetError());
+            SDL_SubmitGPUCommandBuffer(commandBuffer);
+            return;
+        }
+        depthTextureWidth = width;
+        depthTextureHeight = height;
+    }
+    glm::vec3 vector;
+    vector.x = std::cos(pitch) * std::cos(yaw);
+    vector.y = std::sin(pitch);
+    vector.z = std::cos(pitch) * std::sin(yaw);
+    float ratio = static_cast<float>(width) / height;
+    glm::vec3 center = glm::vec3{gridWidth, gridHeight, gridDepth} / 2.0f;
+    glm::vec3 position = center - vector * distance;
+    glm::mat4 view = glm::lookAt(position, position + vector, glm::vec3{0.0f, 1.0f, 0.0f});
+    /* keeps the far side of large grids in view */
+    glm::mat4 proj = glm::perspective(FOV, ratio, NEAR, FAR + distance);
+    glm::mat4 viewProjMatrix = proj * view;
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize.x = width;
+    io.DisplaySize.y = height;
+    DrawImGui();
+    ImDrawData* drawData = ImGui::GetDrawData();
+    ImGui_ImplSDLGPU3_PrepareDrawData(drawData, commandBuffer);
+    /* rays read the cells as they are */
+    bool prepared = true;
+    if (render == RENDER_GREEDY)
+    {
+        prepared = Mesh(commandBuffer);
+    }
+    else if (render == RENDER_FACES)
+    {
+        prepared = Compact(commandBuffer);
+    }
+    if (!prepared)
+    {
+        SDL_SubmitGPUCommandBuffer(commandBuffer);
+        return;
+    }
+    {
+        SDL_GPUColorTargetInfo colorInfo{};
+        SDL_GPUDepthStencilTargetInfo depthInfo{};
+        colorInfo.texture = texture;
+        colorInfo.load_op = SDL_GPU_LOADOP_CLEAR;
+        colorInfo.store_op = SDL_GPU_STOREOP_STORE;
+        depthInfo.texture = depthTexture;
+        depthInfo.load_op = SDL_GPU_LOADOP_CLEAR;
+        depthInfo.stencil_load_op = SDL_GPU_LOADOP_CLEAR;
+        depthInfo.store_op = SDL_GPU_STOREOP_STORE;
+        depthInfo.clear_depth = 1.0f;
+        depthInfo.cycle = true;
+        SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(commandBuffer, &colorInfo, 1, &depthInfo);
+        if (!renderPass)
+        {
+            SDL_Log("Failed to begin render pass: %s", SDL_GetError());
+            SDL_SubmitGPUCommandBuffer(commandBuffer);
+            return;
+        }
+        int32_t size[4] = {gridWidth, gridHeight, gridDepth, 0};
+        if (render == RENDER_MARCH)
+        {
+            Camera camera{glm::inverse(viewProjMatrix), glm::vec4{position, 1.0f}, {gridWidth, gridHeight, gridDepth, 0}};
+            if (layout == LAYOUT_MORTON)
+            {
+                SDL_GPUTexture* fragmentTextures[2] = {brickTextures[drawFrame], superbrickTextures[drawFrame]};
+                SDL_BindGPUGraphicsPipeline(renderPass, mortonMarchGraphicsPipeline);
+                SDL_BindGPUFragmentStorageTextures(renderPass, 0, fragmentTextures, 2);
+                SDL_BindGPUFragmentStorageBuffers(renderPass, 0, &cellBuffers[drawFrame], 1);
+            }
+            else
+            {
+                SDL_GPUTexture* fragmentTextures[3] = {textures[drawFrame], brickTextures[drawFrame], superbrickTextures[drawFrame]};
+                SDL_BindGPUGraphicsPipeline(renderPass, marchGraphicsPipeline);
+                SDL_BindGPUFragmentStorageTextures(renderPass, 0, fragmentTextures, 3);
+            }
+            SDL_PushGPUFragmentUniformData(commandBuffer, 0, &rules, sizeof(rules));
+            SDL_PushGPUFragmentUniformData(commandBuffer, 1, &camera, sizeof(camera));
+            SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+        }
+        else if (render == RENDER_GREEDY)
+        {
+            SDL_GPUBufferBinding vertexBuffer{};
+            vertexBuffer.buffer = quadBuffer;
+            SDL_BindGPUGraphicsPipeline(renderPass, greedyGraphicsPipeline);
+            SDL_BindGPUVertexBuffers(renderPass, 0, &vertexBuffer, 1);
+            SDL_PushGPUVertexUniformData(commandBuffer, 1, size, sizeof(size));
+            SDL_PushGPUVertexUniformData(commandBuffer, 0, &viewProjMatrix, sizeof(viewProjMatrix));
+            SDL_PushGPUFragmentUniformData(commandBuffer, 0, &rules, sizeof(rules));
+            SDL_DrawGPUPrimitivesIndirect(renderPass, chunkDrawBuffer, 0, bricksX * bricksY * bricksZ);
+        }
+        else
+        {
+            SDL_BindGPUGraphicsPipeline(renderPass, graphicsPipeline);
+            SDL_BindGPUVertexStorageBuffers(renderPass, 0, &faceBuffer, 1);
+            SDL_PushGPUVertexUniformData(commandBuffer, 1, size, sizeof(size));
+            SDL_PushGPUVertexUniformData(commandBuffer, 0, &viewProjMatrix, sizeof(viewProjMatrix));
+            SDL_PushGPUFragmentUniformData(commandBuffer, 0, &rules, sizeof(rules));
+            SDL_DrawGPUPrimitivesIndirect(renderPass, drawBuffer, 0, 1);
+        }
+        SDL_EndGPURenderPass(renderPass);
+    }
+    {
+        SDL_GPUColorTargetInfo info{};
+        info.texture = texture;
+        info.load_op = SDL_GPU_LOADOP_LOAD;
+        info.store_op = SDL_GPU_STOREOP_STORE;
+        SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(commandBuffer, &info, 1, nullptr);
+        if (!renderPass)
+        {
+            SDL_Log("Failed to begin render pass: %s", SDL_GetError());
+            SDL_SubmitGPUCommandBuffer(commandBuffer);
+            return;
+        }
+        ImGui_ImplSDLGPU3_RenderDrawData(drawData, commandBuffer, renderPass);
+        SDL_EndGPURenderPass(renderPass);
+    }
+    SDL_SubmitGPUCommandBuffer(commandBuffer);
+}
+
+static void Advance()
+{
+    drawFrame = readFrame;
+    readFrame = writeFrame;
+    writeFrame = (writeFrame + 1) % FRAMES;
+    steps++;
+    frameSteps[readFrame] = steps;
+}
+
+/* both seeded frames share a step that nothing before it is stamped against */
+static void Restart()
+{
+    steps++;
+    frameSteps[readFrame] = steps;
+    frameSteps[drawFrame] = steps;
+    trackedSteps = steps;
+}
+
+/* marks the bricks of a frame with a live cell and then the superbricks with a marked brick, only reading the cells of
+ * bricks next to ones marked in the previous frame unless full */
+static bool Occupy(SDL_GPUCommandBuffer* commandBuffer, int frame, int previous, bool full)
+{
+    SDL_GPUStorageTextureReadWriteBinding textureBinding{};
+    textureBinding.texture = brickTextures[frame];
+    SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, &textureBinding, 1, nullptr, 0);
+    if (!computePass)
+    {
+        SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+        return false;
+    }
+    uint32_t uniforms[4] = {full, rules.boundary, 0, 0};
+    if (layout == LAYOUT_MORTON)
+    {
+        int32_t size[4] = {gridWidth, gridHeight, gridDepth, 0};
+        SDL_BindGPUComputePipeline(computePass, mortonOccupancyPipeline);
+        SDL_BindGPUComputeStorageTextures(computePass, 0, &brickTextures[previous], 1);
+        SDL_BindGPUComputeStorageBuffers(computePass, 0, &cellBuffers[frame], 1);
+        SDL_PushGPUComputeUniformData(commandBuffer, 1, size, sizeof(size));
+    }
+    else
+    {
+        SDL_GPUTexture* inTextures[2] = {textures[frame], brickTextures[previous]};
+        SDL_BindGPUComputePipeline(computePass, occupancyPipeline);
+        SDL_BindGPUComputeStorageTextures(computePass, 0, inTextures, 2);
+    }
+    SDL_PushGPUComputeUniformData(commandBuffer, 0, uniforms, sizeof(uniforms));
+    SDL_DispatchGPUCompute(computePass, bricksX, bricksY, bricksZ);
+    SDL_EndGPUComputePass(computePass);
+    textureBinding.texture = superbrickTextures[frame];
+    computePass = SDL_BeginGPUComputePass(commandBuffer, &textureBinding, 1, nullptr, 0);
+    if (!computePass)
+    {
+        SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+        return false;
+    }
+    SDL_BindGPUComputePipeline(computePass, superbricksPipeline);
+    SDL_BindGPUComputeStorageTextures(computePass, 0, &brickTextures[frame], 1);
+    int groupsX = (bricksX + THREADS - 1) / THREADS;
+    int groupsY = (bricksY + THREADS - 1) / THREADS;
+    int groupsZ = (bricksZ + THREADS - 1) / THREADS;
+    SDL_DispatchGPUCompute(computePass, groupsX, groupsY, groupsZ);
+    SDL_EndGPUComputePass(computePass);
+    return true;
+}
+
+/* stamps the chunks that the newest frame changed from the one before it while greedy meshes are drawn */
+static bool Track(SDL_GPUCommandBuffer* commandBuffer)
+{
+    if (render != RENDER_GREEDY)
+    {
+        return true;
+    }
+    SDL_GPUStorageBufferReadWriteBinding bufferBinding{};
+    bufferBinding.buffer = chunkBuffer;
+    SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, nullptr, 0, &bufferBinding, 1);
+    if (!computePass)
+    {
+        SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+        return false;
+    }
+    if (layout == LAYOUT_MORTON)
+    {
+        SDL_GPUBuffer* inBuffers[2] = {cellBuffers[readFrame], cellBuffers[drawFrame]};
+        int32_t size[4] = {gridWidth, gridHeight, gridDepth, 0};
+        SDL_BindGPUComputePipeline(computePass, mortonDirtyPipeline);
+        SDL_BindGPUComputeStorageBuffers(computePass, 0, inBuffers, 2);
+        SDL_PushGPUComputeUniformData(commandBuffer, 1, size, sizeof(size));
+    }
+    else
+    {
+        SDL_GPUTexture* inTextures[2] = {textures[readFrame], textures[drawFrame]};
+        SDL_BindGPUComputePipeline(computePass, dirtyPipeline);
+        SDL_BindGPUComputeStorageTextures(computePass, 0, inTextures, 2);
+    }
+    SDL_PushGPUComputeUniformData(commandBuffer, 0, &steps, sizeof(steps));
+    SDL_DispatchGPUCompute(computePass, bricksX, bricksY, bricksZ);
+    SDL_EndGPUComputePass(computePass);
+    return true;
+}
+
+/* seeds the newest frame and the one drawn at once and skips straight to the first generation */
+static bool Seed(SDL_GPUCommandBuffer* commandBuffer)
+{
+    bool morton = layout == LAYOUT_MORTON;
+    SDL_GPUStorageTextureReadWriteBinding textureBindings[2]{};
+    SDL_GPUStorageBufferReadWriteBinding bufferBindings[2]{};
+    textureBindings[0].texture = textures[readFrame];
+    textureBindings[1].texture = textures[drawFrame];
+    bufferBindings[0].buffer = cellBuffers[readFrame];
+    bufferBindings[1].buffer = cellBuffers[drawFrame];
+    SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer,
+        textureBindings, morton ? 0 : 2, bufferBindings, morton ? 2 : 0);
+    if (!computePass)
+    {
+        SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+        return false;
+    }
+    int32_t size[4] = {gridWidth, gridHeight, gridDepth, 0};
+    SDL_BindGPUComputePipeline(computePass, morton ? mortonInitPipeline : initPipeline);
+    SDL_PushGPUComputeUniformData(commandBuffer, 0, &rules, sizeof(rules));
+    SDL_PushGPUComputeUniformData(commandBuffer, 1, size, sizeof(size));
+    /* bricks for the buffer layout are groups too */
+    SDL_DispatchGPUCompute(computePass, bricksX, bricksY, bricksZ);
+    SDL_EndGPUComputePass(computePass);
+    for (int i = 0; i < FRAMES; i++)
+    {
+        bitsValid[i] = false;
+    }
+    sparseTracked = false;
+    boundsTracked = false;
+    Restart();
+    rules.frame = 2;
+    return Occupy(commandBuffer, readFrame, drawFrame, true) && Occupy(commandBuffer, drawFrame, readFrame, true);
+}
+
+/* records a generation of every member in one dispatch and copies the selected member out to be drawn */
+static bool SimulateEnsemble(SDL_GPUCommandBuffer* commandBuffer)
+{
+    bool seed = rules.frame < 2;
+    if (seed)
+    {
+        /* the selected member keeps the seed it was reset with */
+        for (int i = 0; i < ensemble; i++)
+        {
+            if (i != member)
+            {
+                members[i].seed = std::rand() % RAND_MAX;
+            }
+        }
+    }
+    members[member] = rules;
+    void* data = SDL_MapGPUTransferBuffer(device, membersTransferBuffer, true);
+    if (!data)
+    {
+        SDL_Log("Failed to map transfer buffer: %s", SDL_GetError());
+        return false;
+    }
+    std::memcpy(data, members.data(), ensemble * sizeof(Rules));
+    SDL_UnmapGPUTransferBuffer(device, membersTransferBuffer);
+    SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+    if (!copyPass)
+    {
+        SDL_Log("Failed to begin copy pass: %s", SDL_GetError());
+        return false;
+    }
+    SDL_GPUTransferBufferLocation location{};
+    SDL_GPUBufferRegion region{};
+    location.transfer_buffer = membersTransferBuffer;
+    region.buffer = membersBuffer;
+    region.size = ensemble * sizeof(Rules);
+    SDL_UploadToGPUBuffer(copyPass, &location, &region, false);
+    SDL_EndGPUCopyPass(copyPass);
+    SDL_GPUStorageTextureReadWriteBinding textureBindings[2]{};
+    textureBindings[0].texture = ensembleTextures[writeFrame];
+    textureBindings[1].texture = ensembleTextures[readFrame];
+    SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, textureBindings, seed ? 2 : 1, nullptr, 0);
+    if (!computePass)
+    {
+        SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+        return false;
+    }
+    int32_t depth = gridDepth;
+    SDL_BindGPUComputePipeline(computePass, seed ? ensembleInitPipeline : ensemblePipeline);
+    SDL_PushGPUComputeUniformData(commandBuffer, 0, &depth, sizeof(depth));
+    if (!seed)
+    {
+        SDL_BindGPUComputeStorageTextures(computePass, 0, &ensembleTextures[readFrame], 1);
+    }
+    SDL_BindGPUComputeStorageBuffers(computePass, 0, &membersBuffer, 1);
+    /* every member is a whole number of groups along z */
+    SDL_DispatchGPUCompute(computePass, bricksX, bricksY, bricksZ * ensemble);
+    SDL_EndGPUComputePass(computePass);
+    if (seed)
+    {
+        Restart();
+        rules.frame = 2;
+    }
+    else
+    {
+        Advance();
+        rules.frame++;
+    }
+    copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+    if (!copyPass)
+    {
+        SDL_Log("Failed to begin copy pass: %s", SDL_GetError());
+        return false;
+    }
+    /* into the interior of the newest texture, which is drawn after the next step, and the drawn one too after seeding */
+    SDL_GPUTextureLocation source{};
+    SDL_GPUTextureLocation destination{};
+    source.texture = ensembleTextures[readFrame];
+    source.z = member * gridDepth;
+    destination.x = 1;
+    destination.y = 1;
+    destination.z = 1;
+    int frames[2] = {readFrame, drawFrame};
+    for (int i = 0; i < (seed ? 2 : 1); i++)
+    {
+        destination.texture = textures[frames[i]];
+        SDL_CopyGPUTextureToTexture(copyPass, &source, &destination, gridWidth, gridHeight, gridDepth, false);
+        bitsValid[frames[i]] = false;
+    }
+    SDL_EndGPUCopyPass(copyPass);
+    if (seed)
+    {
+        return Occupy(commandBuffer, readFrame, drawFrame, true) && Occupy(commandBuffer, drawFrame, readFrame, true);
+    }
+    /* in full since the copied member may not be the one stepped from the frame before */
+    return Occupy(commandBuffer, readFrame, drawFrame, true) && Track(commandBuffer);
+}
+
+/* records a generation so that turbo mode can record many into one command buffer */
+static bool Simulate(SDL_GPUCommandBuffer* commandBuffer)
+{
+    if (ensemble > 0)
+    {
+        return SimulateEnsemble(commandBuffer);
+    }
+    /* frames 0 and 1 used to seed and then copy */
+    if (rules.frame < 2)
+    {
+        return Seed(commandBuffer);
+    }
+    if (layout == LAYOUT_MORTON)
+    {
+        SDL_GPUStorageBufferReadWriteBinding bufferBinding{};
+        bufferBinding.buffer = cellBuffers[writeFrame];
+        SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, nullptr, 0, &bufferBinding, 1);
+        if (!computePass)
+        {
+            SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+            return false;
+        }
+        int32_t size[4] = {gridWidth, gridHeight, gridDepth, 0};
+        SDL_BindGPUComputePipeline(computePass, GetVariant(mortonPipelines));
+        SDL_PushGPUComputeUniformData(commandBuffer, 0, &rules, sizeof(rules));
+        SDL_PushGPUComputeUniformData(commandBuffer, 1, size, sizeof(size));
+        SDL_BindGPUComputeStorageBuffers(computePass, 0, &cellBuffers[readFrame], 1);
+        SDL_DispatchGPUCompute(computePass, bricksX, bricksY, bricksZ);
+        SDL_EndGPUComputePass(computePass);
+        Advance();
+        rules.frame++;
+        return Occupy(commandBuffer, readFrame, drawFrame, rules.birthMask & 1) && Track(commandBuffer);
+    }
+    int groupsX = (gridWidth + THREADS - 1) / THREADS;
+    int groupsY = (gridHeight + THREADS - 1) / THREADS;
+    int groupsZ = (gridDepth + THREADS - 1) / THREADS;
+    int paddedGroupsX = (gridWidth + 2 + THREADS - 1) / THREADS;
+    int paddedGroupsY = (gridHeight + 2 + THREADS - 1) / THREADS;
+    int paddedGroupsZ = (gridDepth + 2 + THREADS - 1) / THREADS;
+    /* temporal blocking loads its own halo and counts directly */
+    bool blocked = temporal > 1;
+    /* packed steps wrap or clip rows themselves and count directly */
+    bool bits = storage == STORAGE_BITS && !blocked;
+    int wordGroupsX = ((gridWidth + 31) / 32 + THREADS - 1) / THREADS;
+    if (!blocked && !bits)
+    {
+        /* the halo is dead or a copy of the opposite side so that kernels never check bounds */
+        SDL_GPUStorageTextureReadWriteBinding textureBinding{};
+        textureBinding.texture = textures[readFrame];
+        SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, &textureBinding, 1, nullptr, 0);
+        if (!computePass)
+        {
+            SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+            return false;
+        }
+        SDL_BindGPUComputePipeline(computePass, haloPipeline);
+        SDL_PushGPUComputeUniformData(commandBuffer, 0, &rules, sizeof(rules));
+        for (uint32_t axis = 0; axis < 3; axis++)
+        {
+            SDL_PushGPUComputeUniformData(commandBuffer, 1, &axis, sizeof(axis));
+            SDL_DispatchGPUCompute(computePass,
+                axis == 0 ? 1 : paddedGroupsX,
+                axis == 1 ? 1 : paddedGroupsY,
+                axis == 2 ? 1 : paddedGroupsZ);
+        }
+        SDL_EndGPUComputePass(computePass);
+    }
+    /* von neumann is not a box so it always counts directly */
+    bool separable = counting == COUNTING_SEPARABLE && !blocked && !bits && rules.neighborhood == MOORE;
+    bool sparseStep = sparse && counting == COUNTING_DIRECT && !blocked && !bits;
+    bool direct = !blocked && !bits && !separable && !sparseStep;
+    if (bits && !bitsValid[readFrame])
+    {
+        /* the bits are only kept up to date by packed steps */
+        SDL_GPUStorageTextureReadWriteBinding textureBinding{};
+        textureBinding.texture = bitTextures[readFrame];
+        SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, &textureBinding, 1, nullptr, 0);
+        if (!computePass)
+        {
+            SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+            return false;
+        }
+        SDL_BindGPUComputePipeline(computePass, packPipeline);
+        SDL_BindGPUComputeStorageTextures(computePass, 0, &textures[readFrame], 1);
+        SDL_DispatchGPUCompute(computePass, wordGroupsX, groupsY, groupsZ);
+        SDL_EndGPUComputePass(computePass);
+        bitsValid[readFrame] = true;
+    }
+    if (separable)
+    {
+        /* sum along x into the first texture and then along y into the second */
+        for (uint32_t axis = 0; axis < 2; axis++)
+        {
+            SDL_GPUStorageTextureReadWriteBinding textureBinding{};
+            textureBinding.texture = sumTextures[axis];
+            SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, &textureBinding, 1, nullptr, 0);
+            if (!computePass)
+            {
+                SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+                return false;
+            }
+            SDL_GPUTexture* inTexture = axis == 0 ? textures[readFrame] : sumTextures[0];
+            SDL_BindGPUComputePipeline(computePass, sumPipeline);
+            SDL_PushGPUComputeUniformData(commandBuffer, 0, &axis, sizeof(axis));
+            SDL_BindGPUComputeStorageTextures(computePass, 0, &inTexture, 1);
+            SDL_DispatchGPUCompute(computePass, paddedGroupsX, paddedGroupsY, paddedGroupsZ);
+            SDL_EndGPUComputePass(computePass);
+        }
+    }
+    if (sparseStep)
+    {
+        /* the changed flags are only valid for consecutive sparse steps with the same rules */
+        bool reset = !sparseTracked ||
+            rules.surviveMask != sparseRules.surviveMask || rules.birthMask != sparseRules.birthMask ||
+            rules.life != sparseRules.life || rules.neighborhood != sparseRules.neighborhood ||
+            rules.boundary != sparseRules.boundary;
+        uint32_t uniforms[6] = {sparseSlot, reset, uint32_t(bricksX), uint32_t(bricksY), uint32_t(bricksZ), rules.boundary};
+        SDL_GPUStorageBufferReadWriteBinding bufferBindings[3]{};
+        bufferBindings[0].buffer = bricksBuffer;
+        bufferBindings[1].buffer = changedBuffer;
+        bufferBindings[2].buffer = argsBuffer;
+        SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, nullptr, 0, bufferBindings, 3);
+        if (!computePass)
+        {
+            SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+            return false;
+        }
+        SDL_BindGPUComputePipeline(computePass, bricksPipeline);
+        SDL_PushGPUComputeUniformData(commandBuffer, 0, uniforms, sizeof(uniforms));
+        SDL_DispatchGPUCompute(computePass,
+            (bricksX + THREADS - 1) / THREADS,
+            (bricksY + THREADS - 1) / THREADS,
+            (bricksZ + THREADS - 1) / THREADS);
+        SDL_EndGPUComputePass(computePass);
+    }
+    if (direct)
+    {
+        /* cells further than one from the live cells of both frames stay dead, and a periodic boundary wraps them */
+        bool shrinking = shrink && boundsTracked && rules.boundary == BOUNDARY_DEAD && !(rules.birthMask & 1);
+        int32_t uniforms[4] = {gridWidth, gridHeight, gridDepth, !shrinking};
+        SDL_GPUStorageBufferReadWriteBinding bufferBinding{};
+        bufferBinding.buffer = boundsBuffer;
+        SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, nullptr, 0, &bufferBinding, 1);
+        if (!computePass)
+        {
+            SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+            return false;
+        }
+        SDL_BindGPUComputePipeline(computePass, boundsPipeline);
+        SDL_PushGPUComputeUniformData(commandBuffer, 0, uniforms, sizeof(uniforms));
+        SDL_DispatchGPUCompute(computePass, 1, 1, 1);
+        SDL_EndGPUComputePass(computePass);
+    }
+    SDL_GPUStorageTextureReadWriteBinding textureBindings[2]{};
+    SDL_GPUStorageBufferReadWriteBinding bufferBinding{};
+    textureBindings[0].texture = textures[writeFrame];
+    textureBindings[1].texture = bitTextures[writeFrame];
+    bufferBinding.buffer = direct ? boundsBuffer : changedBuffer;
+    SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, textureBindings, bits ? 2 : 1, &bufferBinding, sparseStep || direct);
+    if (!computePass)
+    {
+        SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+        return false;
+    }
+    SDL_PushGPUComputeUniformData(commandBuffer, 0, &rules, sizeof(rules));
+    if (blocked)
+    {
+        uint32_t generations = temporal;
+        SDL_BindGPUComputePipeline(computePass, GetVariant(temporalPipelines));
+        SDL_PushGPUComputeUniformData(commandBuffer, 1, &generations, sizeof(generations));
+        SDL_BindGPUComputeStorageTextures(computePass, 0, &textures[readFrame], 1);
+        SDL_DispatchGPUCompute(computePass, groupsX, groupsY, groupsZ);
+    }
+    else if (bits)
+    {
+        SDL_GPUTexture* inTextures[2] = {textures[readFrame], bitTextures[readFrame]};
+        SDL_BindGPUComputePipeline(computePass, GetVariant(packedPipelines));
+        SDL_BindGPUComputeStorageTextures(computePass, 0, inTextures, 2);
+        /* cells dead before and after are only skipped when the ages they held are known to be zero */
+        uint32_t outValid = bitsValid[writeFrame];
+        SDL_PushGPUComputeUniformData(commandBuffer, 1, &outValid, sizeof(outValid));
+        SDL_DispatchGPUCompute(computePass, wordGroupsX, groupsY, groupsZ);
+    }
+    else if (separable)
+    {
+        SDL_GPUTexture* inTextures[2] = {textures[readFrame], sumTextures[1]};
+        SDL_BindGPUComputePipeline(computePass, separablePipeline);
+        SDL_BindGPUComputeStorageTextures(computePass, 0, inTextures, 2);
+        SDL_DispatchGPUCompute(computePass, groupsX, groupsY, groupsZ);
+    }
+    else if (sparseStep)
+    {
+        /* bricks that are not in the list already hold their next state in the write texture */
+        SDL_BindGPUComputePipeline(computePass, GetVariant(sparsePipelines));
+        SDL_PushGPUComputeUniformData(commandBuffer, 1, &sparseSlot, sizeof(sparseSlot));
+        SDL_BindGPUComputeStorageTextures(computePass, 0, &textures[readFrame], 1);
+        SDL_BindGPUComputeStorageBuffers(computePass, 0, &bricksBuffer, 1);
+        SDL_DispatchGPUComputeIndirect(computePass, argsBuffer, sparseSlot * 3 * sizeof(uint32_t));
+    }
+    else
+    {
+        SDL_GPUComputePipeline* pipeline = GetVariant(computePipelines);
+        if (subgroups)
+        {
+            pipeline = GetVariant(subgroupPipelines);
+        }
+        else if (tiled)
+        {
+            pipeline = GetVariant(tiledPipelines);
+        }
+        SDL_BindGPUComputePipeline(computePass, pipeline);
+        SDL_BindGPUComputeStorageTextures(computePass, 0, &textures[readFrame], 1);
+        SDL_DispatchGPUComputeIndirect(computePass, boundsBuffer, 0);
+    }
+    SDL_EndGPUComputePass(computePass);
+    boundsTracked = direct;
+    if (sparseStep)
     {
-        /* happens on minimize */
-        SDL_SubmitGPUCommandBuffer(commandBuffer);
-        return;
+        sparseSlot = (sparseSlot + 1) % FRAMES;
     }
-    if (width != depthTextureWidth || height != depthTextureHeight)
+    sparseTracked = sparseStep;
+    bitsValid[writeFrame] = bits;
+    sparseRules = rules;
+    Advance();
+    rules.frame += blocked ? temporal : 1;
+    return Occupy(commandBuffer, readFrame, drawFrame, rules.birthMask & 1) && Track(commandBuffer);
+}
+
+/* records a reduction of the newest frame against the one before it and its download into the next slot of the ring */
+static bool Measure(SDL_GPUCommandBuffer* commandBuffer)
+{
+    /* ensembles always step textures */
+    bool morton = layout == LAYOUT_MORTON && ensemble == 0;
+    SDL_GPUTexture* inTextures[2] = {textures[readFrame], textures[drawFrame]};
+    SDL_GPUBuffer* inBuffers[2] = {cellBuffers[readFrame], cellBuffers[drawFrame]};
+    SDL_GPUStorageBufferReadWriteBinding bufferBinding{};
+    bufferBinding.buffer = statsBuffer;
+    /* the totals are cleared in a pass of their own so that every group sees them cleared */
+    for (int i = 0; i < 2; i++)
     {
-        SDL_ReleaseGPUTexture(device, depthTexture);
-        SDL_GPUTextureCreateInfo info{};
-        info.type = SDL_GPU_TEXTURETYPE_2D;
-        info.format = SDL_GPU_TEXTUREFORMAT_D32_FLOAT;
-        info.usage = SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET;
-        info.width = width;
-        info.height = height;
-        info.layer_count_or_depth = 1;
-        info.num_levels = 1;
-        info.props = SDL_CreateProperties();
-        SDL_SetFloatProperty(info.props, SDL_PROP_GPU_TEXTURE_CREATE_D3D12_CLEAR_DEPTH_FLOAT, 1.0f);
-        depthTexture = SDL_CreateGPUTexture(device, &info);
-        SDL_DestroyProperties(info.props);
-        if (!depthTexture)
+        uint32_t clear = i == 0;
+        SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, nullptr, 0, &bufferBinding, 1);
+        if (!computePass)
         {
-            SDL_Log("Failed to create texture: %s", SDL_GetError());
-            SDL_SubmitGPUCommandBuffer(commandBuffer);
-            return;
+            SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
+            return false;
         }
-        depthTextureWidth = width;
-        depthTextureHeight = height;
+        if (morton)
+        {
+            int32_t size[4] = {gridWidth, gridHeight, gridDepth, 0};
+            SDL_BindGPUComputePipeline(computePass, mortonStatsPipeline);
+            SDL_BindGPUComputeStorageBuffers(computePass, 0, inBuffers, 2);
+            SDL_PushGPUComputeUniformData(commandBuffer, 1, size, sizeof(size));
+        }
+        else
+        {
+            SDL_BindGPUComputePipeline(computePass, statsPipeline);
+            SDL_BindGPUComputeStorageTextures(computePass, 0, inTextures, 2);
+        }
+        SDL_PushGPUComputeUniformData(commandBuffer, 0, &clear, sizeof(clear));
+        if (clear)
+        {
+            SDL_DispatchGPUCompute(computePass, 1, 1, 1);
+        }
+        else
+        {
+            SDL_DispatchGPUCompute(computePass, bricksX, bricksY, bricksZ);
+        }
+        SDL_EndGPUComputePass(computePass);
     }
-    glm::vec3 vector;
-    vector.x = std::cos(pitch) * std::cos(yaw);
-    vector.y = std::sin(pitch);
-    vector.z = std::cos(pitch) * std::sin(yaw);
-    float ratio = static_cast<float>(width) / height;
-    glm::vec3 center = glm::vec3{BOUNDS / 2};
-    glm::vec3 position = center - vector * distance;
-    glm::mat4 view = glm::lookAt(position, position + vector, glm::vec3{0.0f, 1.0f, 0.0f});
-    glm::mat4 proj = glm::perspective(FOV, ratio, NEAR, FAR);
-    glm::mat4 viewProjMatrix = proj * view;
-    ImGuiIO& io = ImGui::GetIO();
-    io.DisplaySize.x = width;
-    io.DisplaySize.y = height;
-    DrawImGui();
-    ImDrawData* drawData = ImGui::GetDrawData();
-    ImGui_ImplSDLGPU3_PrepareDrawData(drawData, commandBuffer);
+    SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+    if (!copyPass)
     {
-        SDL_GPUColorTargetInfo colorInfo{};
-        SDL_GPUDepthStencilTargetInfo depthInfo{};
-        colorInfo.texture = texture;
-        colorInfo.load_op = SDL_GPU_LOADOP_CLEAR;
-        colorInfo.store_op = SDL_GPU_STOREOP_STORE;
-        depthInfo.texture = depthTexture;
-        depthInfo.load_op = SDL_GPU_LOADOP_CLEAR;
-        depthInfo.stencil_load_op = SDL_GPU_LOADOP_CLEAR;
-        depthInfo.store_op = SDL_GPU_STOREOP_STORE;
-        depthInfo.clear_depth = 1.0f;
-        depthInfo.cycle = true;
-        SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(commandBuffer, &colorInfo, 1, &depthInfo);
-        if (!renderPass)
+        SDL_Log("Failed to begin copy pass: %s", SDL_GetError());
+        return false;
+    }
+    SDL_GPUBufferRegion region{};
+    SDL_GPUTransferBufferLocation location{};
+    region.buffer = statsBuffer;
+    region.size = sizeof(Stats);
+    location.transfer_buffer = statsTransferBuffers[batchHead];
+    SDL_DownloadFromGPUBuffer(copyPass, &region, &location);
+    SDL_EndGPUCopyPass(copyPass);
+    batchFrames[batchHead] = rules.frame;
+    return true;
+}
+
+/* submits a batch into the next slot of the ring, which must be free, and returns its fence while the ring owns it */
+static SDL_GPUFence* Submit(SDL_GPUCommandBuffer* commandBuffer, bool measured, int steps = 0)
+{
+    SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+    if (!fence)
+    {
+        SDL_Log("Failed to submit command buffer: %s", SDL_GetError());
+        return nullptr;
+    }
+    batchFences[batchHead] = fence;
+    batchMeasured[batchHead] = measured;
+    batchSteps[batchHead] = steps;
+    batchStarts[batchHead] = SDL_GetTicksNS();
+    batchBusy[batchHead] = 0;
+    batchHead = (batchHead + 1) % READBACKS;
+    return fence;
+}
+
+/* retires the oldest batch in flight if it finished or when waiting, reads its stats, and returns whether it did */
+static bool Retire(bool wait)
+{
+    SDL_GPUFence* fence = batchFences[batchTail];
+    if (!fence)
+    {
+        return false;
+    }
+    if (wait)
+    {
+        SDL_WaitForGPUFences(device, true, &fence, 1);
+    }
+    else if (!SDL_QueryGPUFence(device, fence))
+    {
+        batchBusy[batchTail] = SDL_GetTicksNS();
+        return false;
+    }
+    SDL_ReleaseGPUFence(device, fence);
+    batchFences[batchTail] = nullptr;
+    /* batches run one after another on the single queue, so each started once the one before it retired */
+    uint64_t now = SDL_GetTicksNS();
+    if (batchSteps[batchTail] > 0)
+    {
+        uint64_t start = std::max(batchStarts[batchTail], retiredTime);
+        /* a batch that finished before any poll found it busy only shows that it fit in the frame, so it grows */
+        double target = 2.0 * batchSteps[batchTail];
+        if (wait || batchBusy[batchTail] > start)
         {
-            SDL_Log("Failed to begin render pass: %s", SDL_GetError());
-            SDL_SubmitGPUCommandBuffer(commandBuffer);
-            return;
+            /* otherwise it ran for somewhere between the last busy poll and now */
+            uint64_t busy = wait ? now : batchBusy[batchTail];
+            double elapsed = std::max(1.0, static_cast<double>(busy - start + now - start) / 2e6);
+            /* grows at most twofold per batch so that one fast batch does not stall a later frame */
+            target = std::min(target, batchSteps[batchTail] * TURBO / elapsed);
         }
-        SDL_BindGPUGraphicsPipeline(renderPass, graphicsPipeline);
-        SDL_GPUBufferBinding vertexBuffers[2]{};
-        vertexBuffers[0].buffer = vertexBuffer;
-        vertexBuffers[1].buffer = instanceBuffer;
-        /* TODO: read or write, which is better? */
-        SDL_BindGPUVertexBuffers(renderPass, 0, vertexBuffers, 2);
-        SDL_BindGPUVertexStorageTextures(renderPass, 0, &textures[writeFrame], 1);
-        SDL_PushGPUVertexUniformData(commandBuffer, 0, &viewProjMatrix, sizeof(viewProjMatrix));
-        SDL_PushGPUFragmentUniformData(commandBuffer, 0, &rules, sizeof(rules));
-        SDL_DrawGPUPrimitives(renderPass, 36, BOUNDS * BOUNDS * BOUNDS, 0, 0);
-        SDL_EndGPURenderPass(renderPass);
+        turboSteps = std::clamp(static_cast<int>(target), 1, 1 << 16);
     }
+    retiredTime = now;
+    void* data = batchMeasured[batchTail] ? SDL_MapGPUTransferBuffer(device, statsTransferBuffers[batchTail], false) : nullptr;
+    if (data)
     {
-        SDL_GPUColorTargetInfo info{};
-        info.texture = texture;
-        info.load_op = SDL_GPU_LOADOP_LOAD;
-        info.store_op = SDL_GPU_STOREOP_STORE;
-        SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(commandBuffer, &info, 1, nullptr);
-        if (!renderPass)
+        std::memcpy(&stats, data, sizeof(stats));
+        SDL_UnmapGPUTransferBuffer(device, statsTransferBuffers[batchTail]);
+        statsFrame = batchFrames[batchTail];
+        statsValid = true;
+    }
+    else if (batchMeasured[batchTail])
+    {
+        SDL_Log("Failed to map transfer buffer: %s", SDL_GetError());
+    }
+    batchTail = (batchTail + 1) % READBACKS;
+    return true;
+}
+
+static void LogStats()
+{
+    uint64_t total = 0;
+    for (int i = 0; i < STATS_AGES; i++)
+    {
+        total += static_cast<uint64_t>(i + 1) * stats.ages[i];
+    }
+    double age = stats.alive > 0 ? static_cast<double>(total) / stats.alive : 0.0;
+    SDL_Log("Generation %u: %u alive, %u births, %u deaths, %.2f mean age, bounds (%u, %u, %u) to (%u, %u, %u)",
+        statsFrame, stats.alive, stats.births, stats.deaths, age,
+        stats.minimum[0], stats.minimum[1], stats.minimum[2],
+        stats.maximum[0], stats.maximum[1], stats.maximum[2]);
+}
+
+/* steps and measures every generation without drawing, waiting on the ring only when it is full */
+static bool Headless()
+{
+    for (int i = 0; i < headless; i++)
+    {
+        if (batchFences[batchHead] && Retire(true) && statsValid)
         {
-            SDL_Log("Failed to begin render pass: %s", SDL_GetError());
-            SDL_SubmitGPUCommandBuffer(commandBuffer);
-            return;
+            LogStats();
+        }
+        SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(device);
+        if (!commandBuffer)
+        {
+            SDL_Log("Failed to acquire command buffer: %s", SDL_GetError());
+            return false;
+        }
+        if (!Simulate(commandBuffer))
+        {
+            SDL_CancelGPUCommandBuffer(commandBuffer);
+            return false;
+        }
+        Submit(commandBuffer, Measure(commandBuffer));
+        while (Retire(false) && statsValid)
+        {
+            LogStats();
         }
-        ImGui_ImplSDLGPU3_RenderDrawData(drawData, commandBuffer, renderPass);
-        SDL_EndGPURenderPass(renderPass);
     }
-    SDL_SubmitGPUCommandBuffer(commandBuffer);
+    while (Retire(true) && statsValid)
+    {
+        LogStats();
+    }
+    /* sweeps over the rules of the members end with the population of each */
+    if (ensemble > 0)
+    {
+        ReadMembers();
+    }
+    return true;
+}
+
+/* records batches of generations with each layout and logs the time per generation once they finish */
+static bool Benchmark()
+{
+    const char* names[] = {"texture", "morton"};
+    const int Batches = 8;
+    const int Steps = 32;
+    /* ensembles ignore the layout */
+    for (int i = 0; i < (ensemble > 0 ? 1 : 2); i++)
+    {
+        layout = i;
+        rules.frame = 0;
+        double time = 0.0;
+        /* the first batch seeds and warms up */
+        for (int batch = 0; batch <= Batches; batch++)
+        {
+            SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(device);
+            if (!commandBuffer)
+            {
+                SDL_Log("Failed to acquire command buffer: %s", SDL_GetError());
+                return false;
+            }
+            for (int step = 0; step < Steps; step++)
+            {
+                if (!Simulate(commandBuffer))
+                {
+                    SDL_CancelGPUCommandBuffer(commandBuffer);
+                    return false;
+                }
+            }
+            uint64_t start = SDL_GetTicksNS();
+            SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+            if (!fence)
+            {
+                SDL_Log("Failed to submit command buffer: %s", SDL_GetError());
+                return false;
+            }
+            SDL_WaitForGPUFences(device, true, &fence, 1);
+            SDL_ReleaseGPUFence(device, fence);
+            if (batch > 0)
+            {
+                time += static_cast<double>(SDL_GetTicksNS() - start) / 1e6;
+            }
+        }
+        SDL_Log("%s: %dx%dx%d, %.3f ms per generation", ensemble > 0 ? "ensemble" : names[i], gridWidth, gridHeight, gridDepth, time / (Batches * Steps));
+    }
+    return true;
 }
 
-static void Simulate()
+/* records as many generations as the last retired batch suggests fit in TURBO milliseconds, without waiting on them */
+static void Turbo()
 {
     SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(device);
     if (!commandBuffer)
@@ -522,35 +1989,119 @@ static void Simulate()
         SDL_Log("Failed to acquire command buffer: %s", SDL_GetError());
         return;
     }
-    SDL_GPUStorageTextureReadWriteBinding textureBinding{};
-    textureBinding.texture = textures[writeFrame];
-    SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, &textureBinding, 1, nullptr, 0);
-    if (!computePass)
+    for (int i = 0; i < turboSteps; i++)
     {
-        SDL_Log("Failed to begin compute pass: %s", SDL_GetError());
-        SDL_SubmitGPUCommandBuffer(commandBuffer);
-        return;
+        if (!Simulate(commandBuffer))
+        {
+            break;
+        }
     }
-    SDL_BindGPUComputePipeline(computePass, computePipeline);
-    SDL_PushGPUComputeUniformData(commandBuffer, 0, &rules, sizeof(rules));
-    SDL_BindGPUComputeStorageTextures(computePass, 0, &textures[readFrame], 1);
-    int groups = (BOUNDS + THREADS - 1) / THREADS;
-    SDL_DispatchGPUCompute(computePass, groups, groups, groups);
-    SDL_EndGPUComputePass(computePass);
-    SDL_SubmitGPUCommandBuffer(commandBuffer);
-    readFrame = (readFrame + 1) % FRAMES;
-    writeFrame = (writeFrame + 1) % FRAMES;
-    rules.frame++;
+    /* timed and retired with the rest of the ring */
+    Submit(commandBuffer, Measure(commandBuffer), turboSteps);
 }
 
 int main(int argc, char** argv)
 {
+    /* either a single size for a cube or a width, height and depth, mixed with options */
+    int sizes[3];
+    int count = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--untiled") == 0)
+        {
+            tiled = false;
+        }
+        else if (std::strcmp(argv[i], "--subgroups") == 0)
+        {
+            subgroups = true;
+        }
+        else if (std::strcmp(argv[i], "--benchmark") == 0)
+        {
+            benchmark = true;
+        }
+        else if (std::strcmp(argv[i], "--headless") == 0 && i + 1 < argc)
+        {
+            headless = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--ensemble") == 0 && i + 1 < argc)
+        {
+            ensemble = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--ensemble-rules") == 0 && i + 1 < argc)
+        {
+            memberRulesPath = argv[++i];
+        }
+        else if (count < 3)
+        {
+            sizes[count++] = std::atoi(argv[i]);
+        }
+        else
+        {
+            count++;
+        }
+    }
+    if (count == 1)
+    {
+        gridWidth = sizes[0];
+        gridHeight = sizes[0];
+        gridDepth = sizes[0];
+    }
+    else if (count == 3)
+    {
+        gridWidth = sizes[0];
+        gridHeight = sizes[1];
+        gridDepth = sizes[2];
+    }
+    else if (count != 0)
+    {
+        SDL_Log("Expected one or three sizes but got %d", count);
+        return 1;
+    }
+    if (gridWidth <= 0 || gridHeight <= 0 || gridDepth <= 0)
+    {
+        SDL_Log("Bad grid size: %dx%dx%d", gridWidth, gridHeight, gridDepth);
+        return 1;
+    }
+    bricksX = (gridWidth + THREADS - 1) / THREADS;
+    bricksY = (gridHeight + THREADS - 1) / THREADS;
+    bricksZ = (gridDepth + THREADS - 1) / THREADS;
+    /* 3d textures are only guaranteed up to 2048 along each axis with the halo, and buffer sizes are 32 bits */
+    uint64_t cells = static_cast<uint64_t>(bricksX) * bricksY * bricksZ * THREADS * THREADS * THREADS;
+    if (gridWidth > 2046 || gridHeight > 2046 || gridDepth > 2046 || cells > UINT32_MAX)
+    {
+        SDL_Log("Grid too large: %dx%dx%d", gridWidth, gridHeight, gridDepth);
+        return 1;
+    }
+    if (memberRulesPath)
+    {
+        if (!LoadMemberRules(memberRulesPath))
+        {
+            return 1;
+        }
+        /* the file sets the number of members unless --ensemble does */
+        if (ensemble == 0)
+        {
+            ensemble = static_cast<int>(memberRules.size());
+        }
+        if (static_cast<int>(memberRules.size()) > ensemble)
+        {
+            SDL_Log("Too many ensemble rules: %d for %d members", static_cast<int>(memberRules.size()), ensemble);
+            return 1;
+        }
+    }
+    /* members are stacked along z in one texture */
+    if (ensemble < 0 || ensemble * gridDepth > 2048)
+    {
+        SDL_Log("Bad ensemble size: %d members of depth %d", ensemble, gridDepth);
+        return 1;
+    }
+    distance = 2.0f * std::max({gridWidth, gridHeight, gridDepth});
     if (!Init())
     {
         SDL_Log("Failed to initialize");
         return 1;
     }
-    if (!CreatePipelines())
+    if ((headless == 0 && !CreateGraphicsPipelines()) || !CreatePipelines())
     {
         SDL_Log("Failed to create pipelines");
         return 1;
@@ -560,9 +2111,39 @@ int main(int argc, char** argv)
         SDL_Log("Failed to create resources");
         return 1;
     }
+    /* the largest grids have too many cells for faces and march instead */
+    if (headless == 0 && !CreateFaces())
+    {
+        render = RENDER_MARCH;
+    }
     std::srand(std::time(nullptr));
     rules.seed = std::rand() % RAND_MAX;
+    members.assign(ensemble, rules);
+    std::copy(memberRules.begin(), memberRules.end(), members.begin());
+    if (ensemble > 0)
+    {
+        /* the settings edit the selected member, which starts as the first with the seed above */
+        uint32_t seed = rules.seed;
+        rules = members[member];
+        rules.seed = seed;
+    }
     bool running = true;
+    if (benchmark)
+    {
+        running = false;
+        if (!Benchmark())
+        {
+            SDL_Log("Failed to benchmark");
+        }
+    }
+    else if (headless > 0)
+    {
+        running = false;
+        if (!Headless())
+        {
+            SDL_Log("Failed to run headless");
+        }
+    }
     while (running)
     {
         time2 = SDL_GetTicks();
@@ -606,29 +2187,131 @@ int main(int argc, char** argv)
         {
             break;
         }
+        while (Retire(false))
+        {
+        }
         Draw();
+        /* the gpu is still busy with earlier batches, so another would only queue behind them */
+        if (batchFences[batchHead])
+        {
+            continue;
+        }
+        if (delay == 0.0f)
+        {
+            /* one batch at a time so that each is timed from its own submission and draws never queue behind several */
+            if (!batchFences[batchTail])
+            {
+                Turbo();
+            }
+            continue;
+        }
         if (delta < delay)
         {
             continue;
         }
         delta = 0.0f;
-        Simulate();
+        SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(device);
+        if (!commandBuffer)
+        {
+            SDL_Log("Failed to acquire command buffer: %s", SDL_GetError());
+            continue;
+        }
+        Simulate(commandBuffer);
+        Submit(commandBuffer, Measure(commandBuffer));
+    }
+    while (Retire(true))
+    {
     }
     for (int i = 0; i < FRAMES; i++)
     {
         SDL_ReleaseGPUTexture(device, textures[i]);
     }
+    for (int i = 0; i < 2; i++)
+    {
+        SDL_ReleaseGPUTexture(device, sumTextures[i]);
+    }
+    for (int i = 0; i < FRAMES; i++)
+    {
+        SDL_ReleaseGPUTexture(device, brickTextures[i]);
+        SDL_ReleaseGPUTexture(device, superbrickTextures[i]);
+    }
+    for (int i = 0; i < FRAMES; i++)
+    {
+        SDL_ReleaseGPUTexture(device, bitTextures[i]);
+    }
+    for (int i = 0; i < FRAMES; i++)
+    {
+        SDL_ReleaseGPUTexture(device, ensembleTextures[i]);
+    }
     SDL_ReleaseGPUTexture(device, depthTexture);
-    SDL_ReleaseGPUBuffer(device, vertexBuffer);
-    SDL_ReleaseGPUBuffer(device, instanceBuffer);
-    ImGui_ImplSDLGPU3_Shutdown();
-    ImGui_ImplSDL3_Shutdown();
-    ImGui::DestroyContext();
+    SDL_ReleaseGPUBuffer(device, faceBuffer);
+    SDL_ReleaseGPUBuffer(device, drawBuffer);
+    SDL_ReleaseGPUTransferBuffer(device, drawTransferBuffer);
+    SDL_ReleaseGPUBuffer(device, chunkBuffer);
+    SDL_ReleaseGPUBuffer(device, quadBuffer);
+    SDL_ReleaseGPUBuffer(device, chunkDrawBuffer);
+    SDL_ReleaseGPUBuffer(device, bricksBuffer);
+    SDL_ReleaseGPUBuffer(device, changedBuffer);
+    SDL_ReleaseGPUBuffer(device, argsBuffer);
+    SDL_ReleaseGPUBuffer(device, boundsBuffer);
+    SDL_ReleaseGPUBuffer(device, membersBuffer);
+    SDL_ReleaseGPUTransferBuffer(device, membersTransferBuffer);
+    SDL_ReleaseGPUBuffer(device, statsBuffer);
+    for (int i = 0; i < READBACKS; i++)
+    {
+        SDL_ReleaseGPUTransferBuffer(device, statsTransferBuffers[i]);
+    }
+    for (int i = 0; i < FRAMES; i++)
+    {
+        SDL_ReleaseGPUBuffer(device, cellBuffers[i]);
+    }
+    if (window)
+    {
+        ImGui_ImplSDLGPU3_Shutdown();
+        ImGui_ImplSDL3_Shutdown();
+        ImGui::DestroyContext();
+    }
     SDL_ReleaseGPUGraphicsPipeline(device, graphicsPipeline);
-    SDL_ReleaseGPUComputePipeline(device, computePipeline);
-    SDL_ReleaseWindowFromGPUDevice(device, window);
+    SDL_ReleaseGPUGraphicsPipeline(device, greedyGraphicsPipeline);
+    SDL_ReleaseGPUGraphicsPipeline(device, marchGraphicsPipeline);
+    SDL_ReleaseGPUGraphicsPipeline(device, mortonMarchGraphicsPipeline);
+    SDL_ReleaseGPUComputePipeline(device, initPipeline);
+    ReleaseVariants(computePipelines);
+    SDL_ReleaseGPUComputePipeline(device, sumPipeline);
+    SDL_ReleaseGPUComputePipeline(device, separablePipeline);
+    SDL_ReleaseGPUComputePipeline(device, bricksPipeline);
+    ReleaseVariants(sparsePipelines);
+    SDL_ReleaseGPUComputePipeline(device, haloPipeline);
+    ReleaseVariants(temporalPipelines);
+    ReleaseVariants(tiledPipelines);
+    ReleaseVariants(subgroupPipelines);
+    SDL_ReleaseGPUComputePipeline(device, packPipeline);
+    ReleaseVariants(packedPipelines);
+    SDL_ReleaseGPUComputePipeline(device, mortonInitPipeline);
+    ReleaseVariants(mortonPipelines);
+    SDL_ReleaseGPUComputePipeline(device, ensembleInitPipeline);
+    SDL_ReleaseGPUComputePipeline(device, ensemblePipeline);
+    SDL_ReleaseGPUComputePipeline(device, statsPipeline);
+    SDL_ReleaseGPUComputePipeline(device, mortonStatsPipeline);
+    SDL_ReleaseGPUComputePipeline(device, boundsPipeline);
+    SDL_ReleaseGPUComputePipeline(device, compactPipeline);
+    SDL_ReleaseGPUComputePipeline(device, mortonCompactPipeline);
+    SDL_ReleaseGPUComputePipeline(device, dirtyPipeline);
+    SDL_ReleaseGPUComputePipeline(device, mortonDirtyPipeline);
+    SDL_ReleaseGPUComputePipeline(device, greedyPipeline);
+    SDL_ReleaseGPUComputePipeline(device, mortonGreedyPipeline);
+    SDL_ReleaseGPUComputePipeline(device, occupancyPipeline);
+    SDL_ReleaseGPUComputePipeline(device, mortonOccupancyPipeline);
+    SDL_ReleaseGPUComputePipeline(device, superbricksPipeline);
+    if (window)
+    {
+        SDL_ReleaseWindowFromGPUDevice(device, window);
+    }
     SDL_DestroyGPUDevice(device);
-    SDL_DestroyWindow(window);
+    if (window)
+    {
+        SDL_DestroyWindow(window);
+    }
     SDL_Quit();
     return 0;
 }
\ No newline at end of file
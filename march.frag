@@ -0,0 +1,20 @@
+#version 450
+
+#include "config.hpp"
+
+layout(set = 2, binding = 0, r8ui) uniform readonly uimage3D cells;
+layout(set = 2, binding = 1, r8ui) uniform readonly uimage3D bricks;
+layout(set = 2, binding = 2, r8ui) uniform readonly uimage3D superbricks;
+
+#include "march.glsl"
+
+uint GetCell(ivec3 id)
+{
+    /* the textures have a one cell halo */
+    return imageLoad(cells, id + 1).x;
+}
+
+void main()
+{
+    March();
+}
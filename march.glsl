@@ -0,0 +1,79 @@
+layout(location = 0) in vec2 inPosition;
+layout(location = 0) out vec4 outColor;
+layout(set = 3, binding = 0) uniform uniformRules
+{
+    uint seed;
+    uint surviveMask;
+    uint birthMask;
+    uint life;
+    uint neighborhood;
+    uint frame;
+};
+layout(set = 3, binding = 1) uniform uniformCamera
+{
+    mat4 inverseViewProjMatrix;
+    vec3 position;
+    ivec3 size;
+};
+
+/* defined by the includer, along with the bricks and superbricks that have a live cell */
+uint GetCell(ivec3 id);
+
+/* marches the ray of the fragment through the cells with a 3D DDA until a live one, across the bounds of the grid and
+ * skipping empty space */
+void March()
+{
+    vec4 target = inverseViewProjMatrix * vec4(inPosition, 1.0f, 1.0f);
+    vec3 direction = normalize(target.xyz / target.w - position);
+    /* cells are centered on whole coordinates, so the grid spans zero to size when shifted by half a cell */
+    vec3 origin = position + 0.5f;
+    vec3 lower = (vec3(0.0f) - origin) / direction;
+    vec3 upper = (vec3(size) - origin) / direction;
+    vec3 first = min(lower, upper);
+    vec3 last = max(lower, upper);
+    float enter = max(max(first.x, first.y), max(first.z, 0.0f));
+    float exit = min(last.x, min(last.y, last.z));
+    if (enter >= exit)
+    {
+        discard;
+    }
+    vec3 start = origin + direction * enter;
+    ivec3 cell = clamp(ivec3(floor(start)), ivec3(0), size - 1);
+    ivec3 advance = ivec3(sign(direction));
+    for (int i = 0; i < size.x + size.y + size.z; i++)
+    {
+        /* empty superbricks and bricks are crossed in one step, and cells one at a time otherwise */
+        int scale = 1;
+        if (imageLoad(superbricks, cell / (THREADS * THREADS)).x == 0)
+        {
+            scale = THREADS * THREADS;
+        }
+        else if (imageLoad(bricks, cell / THREADS).x == 0)
+        {
+            scale = THREADS;
+        }
+        else
+        {
+            uint value = GetCell(cell);
+            if (value > 0)
+            {
+                vec3 color1 = vec3(1.0f, 1.0f, 0.0f);
+                vec3 color2 = vec3(1.0f, 0.0f, 1.0f);
+                outColor = vec4(mix(color1, color2, float(value) / float(life)), 1.0f);
+                return;
+            }
+        }
+        /* leaves the box of the step through its nearest side, never along an axis the ray is parallel to */
+        ivec3 low = cell / scale * scale;
+        vec3 exits = (vec3(low + max(advance, ivec3(0)) * scale) - origin) / direction;
+        exits = mix(exits, vec3(1e30f), equal(advance, ivec3(0)));
+        int axis = exits.x < exits.y && exits.x < exits.z ? 0 : (exits.y < exits.z ? 1 : 2);
+        cell = clamp(ivec3(floor(origin + direction * exits[axis])), low, low + scale - 1);
+        cell[axis] = advance[axis] > 0 ? low[axis] + scale : low[axis] - 1;
+        if (any(lessThan(cell, ivec3(0))) || any(greaterThanEqual(cell, size)))
+        {
+            break;
+        }
+    }
+    discard;
+}
@@ -0,0 +1,11 @@
+#version 450
+
+layout(location = 0) out vec2 outPosition;
+
+void main()
+{
+    /* one triangle over the whole screen, whose fragments each march a ray */
+    vec2 position = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2) * 2.0f - 1.0f;
+    outPosition = position;
+    gl_Position = vec4(position, 0.0f, 1.0f);
+}
@@ -0,0 +1,37 @@
+/* cells are grouped into bricks of THREADS^3 laid out along x, then y and then z, and ordered along a z-order curve inside each */
+const uint BrickCells = THREADS * THREADS * THREADS;
+
+uint Spread(uint value)
+{
+    uint result = 0;
+    for (uint i = 0; (THREADS >> i) > 1; i++)
+    {
+        result |= ((value >> i) & 1) << (3 * i);
+    }
+    return result;
+}
+
+uint Compact(uint value)
+{
+    uint result = 0;
+    for (uint i = 0; (THREADS >> i) > 1; i++)
+    {
+        result |= ((value >> (3 * i)) & 1) << i;
+    }
+    return result;
+}
+
+uint GetMortonIndex(ivec3 id, ivec3 size)
+{
+    ivec3 bricks = (size + THREADS - 1) / THREADS;
+    ivec3 brick = id / THREADS;
+    uvec3 local = uvec3(id % THREADS);
+    uint index = uint((brick.z * bricks.y + brick.y) * bricks.x + brick.x);
+    return index * BrickCells + (Spread(local.x) | (Spread(local.y) << 1) | (Spread(local.z) << 2));
+}
+
+/* the cell of a brick at a position along its curve */
+ivec3 GetMortonCell(uint index)
+{
+    return ivec3(Compact(index), Compact(index >> 1), Compact(index >> 2));
+}
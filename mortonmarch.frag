@@ -0,0 +1,24 @@
+#version 450
+
+#include "config.hpp"
+#include "morton.glsl"
+
+layout(set = 2, binding = 0, r8ui) uniform readonly uimage3D bricks;
+layout(set = 2, binding = 1, r8ui) uniform readonly uimage3D superbricks;
+layout(set = 2, binding = 2) readonly buffer cellBuffer
+{
+    uint cells[];
+};
+
+#include "march.glsl"
+
+uint GetCell(ivec3 id)
+{
+    uint index = GetMortonIndex(id, size);
+    return (cells[index / 4] >> (index % 4 * 8)) & 0xFF;
+}
+
+void main()
+{
+    March();
+}
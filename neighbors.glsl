@@ -0,0 +1,44 @@
+const ivec3 Moore[26] = ivec3[]
+(
+    ivec3(-1,-1,-1), ivec3( 0,-1,-1), ivec3( 1,-1,-1),
+    ivec3(-1, 0,-1), ivec3( 0, 0,-1), ivec3( 1, 0,-1),
+    ivec3(-1, 1,-1), ivec3( 0, 1,-1), ivec3( 1, 1,-1),
+    ivec3(-1,-1, 0), ivec3( 0,-1, 0), ivec3( 1,-1, 0),
+    ivec3(-1, 0, 0),                  ivec3( 1, 0, 0),
+    ivec3(-1, 1, 0), ivec3( 0, 1, 0), ivec3( 1, 1, 0),
+    ivec3(-1,-1, 1), ivec3( 0,-1, 1), ivec3( 1,-1, 1),
+    ivec3(-1, 0, 1), ivec3( 0, 0, 1), ivec3( 1, 0, 1),
+    ivec3(-1, 1, 1), ivec3( 0, 1, 1), ivec3( 1, 1, 1)
+);
+
+const ivec3 VonNeumann[6] = ivec3[]
+(
+    ivec3(-1, 0, 0),
+    ivec3( 1, 0, 0),
+    ivec3( 0,-1, 0),
+    ivec3( 0, 1, 0),
+    ivec3( 0, 0,-1),
+    ivec3( 0, 0, 1)
+);
+
+/* expects inCells to be declared with a filled halo so that no neighbor is out of range */
+uint Count(ivec3 id)
+{
+    uint neighbors = 0;
+    switch (NEIGHBORHOOD)
+    {
+    case MOORE:
+        for (int i = 0; i < 26; i++)
+        {
+            neighbors += uint(imageLoad(inCells, id + Moore[i]).x > 0);
+        }
+        break;
+    case VON_NEUMANN:
+        for (int i = 0; i < 6; i++)
+        {
+            neighbors += uint(imageLoad(inCells, id + VonNeumann[i]).x > 0);
+        }
+        break;
+    }
+    return neighbors;
+}
@@ -0,0 +1,56 @@
+layout(set = 2, binding = 0) uniform uniformOccupancy
+{
+    uint full;
+    uint boundary;
+};
+
+shared uint groupNear;
+shared uint groupOccupied;
+
+/* whether a brick around this one had a live cell in the frame before, since births need live neighbors and a step
+ * moves less than a brick */
+bool IsNear(ivec3 brick)
+{
+    ivec3 count = imageSize(previous);
+    for (int z = -1; z <= 1; z++)
+    for (int y = -1; y <= 1; y++)
+    for (int x = -1; x <= 1; x++)
+    {
+        ivec3 neighbor = brick + ivec3(x, y, z);
+        if (boundary == BOUNDARY_PERIODIC)
+        {
+            neighbor = (neighbor + count) % count;
+        }
+        else if (any(lessThan(neighbor, ivec3(0))) || any(greaterThanEqual(neighbor, count)))
+        {
+            continue;
+        }
+        if (imageLoad(previous, neighbor).x != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* marks the brick of the group if it has a live cell, from a GetCell of the includer, without reading its cells when
+ * no brick around it had one unless full, and must be reached by every invocation */
+void Occupy(ivec3 id, ivec3 size)
+{
+    ivec3 brick = ivec3(gl_WorkGroupID);
+    if (gl_LocalInvocationIndex == 0)
+    {
+        groupNear = uint(full != 0 || IsNear(brick));
+        groupOccupied = 0;
+    }
+    barrier();
+    if (groupNear != 0 && all(lessThan(id, size)) && GetCell(id) > 0)
+    {
+        atomicOr(groupOccupied, 1);
+    }
+    barrier();
+    if (gl_LocalInvocationIndex == 0)
+    {
+        imageStore(bricks, brick, uvec4(groupOccupied));
+    }
+}
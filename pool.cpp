@@ -0,0 +1,145 @@
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pool.hpp"
+
+static bool Pop(Worker& worker, int& task)
+{
+    std::lock_guard lock(worker.mutex);
+    if (worker.tasks.empty())
+    {
+        return false;
+    }
+    task = worker.tasks.front();
+    worker.tasks.pop_front();
+    return true;
+}
+
+static bool Steal(Worker& worker, int& task)
+{
+    std::lock_guard lock(worker.mutex);
+    if (worker.tasks.empty())
+    {
+        return false;
+    }
+    task = worker.tasks.back();
+    worker.tasks.pop_back();
+    return true;
+}
+
+static void Work(Pool& pool, int index)
+{
+    int count = pool.workers.size();
+    while (true)
+    {
+        int task;
+        bool found = Pop(*pool.workers[index], task);
+        for (int i = 1; i < count && !found; i++)
+        {
+            found = Steal(*pool.workers[(index + i) % count], task);
+        }
+        if (!found)
+        {
+            return;
+        }
+        pool.function(task, index);
+        if (--pool.pending == 0)
+        {
+            std::lock_guard lock(pool.mutex);
+            pool.finish.notify_all();
+        }
+    }
+}
+
+static void Loop(Pool& pool, int index)
+{
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock(pool.mutex);
+            pool.start.wait(lock, [&]()
+            {
+                return !pool.running || pool.generation != generation;
+            });
+            if (!pool.running)
+            {
+                return;
+            }
+            generation = pool.generation;
+        }
+        Work(pool, index);
+    }
+}
+
+void CreatePool(Pool& pool, int threads)
+{
+    pool.running = true;
+    for (int i = 0; i < threads; i++)
+    {
+        pool.workers.push_back(std::make_unique<Worker>());
+    }
+    /* the calling thread is the first worker */
+    for (int i = 1; i < threads; i++)
+    {
+        pool.threads.emplace_back(Loop, std::ref(pool), i);
+    }
+}
+
+void DestroyPool(Pool& pool)
+{
+    {
+        std::lock_guard lock(pool.mutex);
+        pool.running = false;
+    }
+    pool.start.notify_all();
+    for (std::thread& thread : pool.threads)
+    {
+        thread.join();
+    }
+    pool.threads.clear();
+    pool.workers.clear();
+}
+
+void RunPool(Pool& pool, int tasks, const std::function<void(int task, int worker)>& function)
+{
+    if (tasks == 0)
+    {
+        return;
+    }
+    int count = pool.workers.size();
+    pool.function = function;
+    pool.pending = tasks;
+    /* contiguous tasks go to the same worker so neighboring slabs stay on one core */
+    for (int i = 0; i < count; i++)
+    {
+        std::lock_guard lock(pool.workers[i]->mutex);
+        for (int task = i * tasks / count; task < (i + 1) * tasks / count; task++)
+        {
+            pool.workers[i]->tasks.push_back(task);
+        }
+    }
+    {
+        std::lock_guard lock(pool.mutex);
+        pool.generation++;
+    }
+    pool.start.notify_all();
+    Work(pool, 0);
+    std::unique_lock lock(pool.mutex);
+    pool.finish.wait(lock, [&]()
+    {
+        return pool.pending == 0;
+    });
+}
+
+int GetPoolThreads(const Pool& pool)
+{
+    return pool.workers.size();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Worker
+{
+    std::mutex mutex;
+    std::deque<int> tasks;
+};
+
+/* fixed set of threads where each thread pops its own tasks and steals from the others when it runs out */
+struct Pool
+{
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::function<void(int task, int worker)> function;
+    std::mutex mutex;
+    std::condition_variable start;
+    std::condition_variable finish;
+    std::atomic<int> pending{0};
+    uint64_t generation{0};
+    bool running{false};
+};
+
+void CreatePool(Pool& pool, int threads);
+void DestroyPool(Pool& pool);
+void RunPool(Pool& pool, int tasks, const std::function<void(int task, int worker)>& function);
+int GetPoolThreads(const Pool& pool);
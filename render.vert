@@ -1,27 +1,43 @@
 #version 450
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in uint inInstance;
 layout(location = 0) out flat uint outValue;
-layout(set = 0, binding = 0, r8ui) uniform readonly uimage3D cells;
+/* written by compact.comp or mortoncompact.comp */
+layout(set = 0, binding = 0) readonly buffer faceBuffer
+{
+    uvec2 faces[];
+};
 layout(set = 1, binding = 0) uniform uniformViewProjMatrix
 {
     mat4 viewProjMatrix;
 };
+layout(set = 1, binding = 1) uniform uniformSize
+{
+    ivec3 size;
+};
 
 void main()
 {
-    ivec3 instance;
-    instance.x = int((inInstance >>  0) & 0x3FF);
-    instance.y = int((inInstance >> 10) & 0x3FF);
-    instance.z = int((inInstance >> 20) & 0x3FF);
-    outValue = imageLoad(cells, instance).x;
-    if (outValue > 0)
-    {
-        gl_Position = viewProjMatrix * vec4(inPosition + vec3(instance), 1.0f);
-    }
-    else
+    /* pulls six vertices per face of a cube from the instance and vertex indices alone */
+    uvec2 cell = faces[gl_InstanceIndex];
+    uint face = uint(gl_VertexIndex) / 6;
+    if (((cell.y >> face) & 1) == 0)
     {
         gl_Position = vec4(0.0f, 0.0f, 2.0f, 1.0f);
+        outValue = 0;
+        return;
     }
-}
\ No newline at end of file
+    ivec3 instance;
+    instance.x = int(cell.x % uint(size.x));
+    instance.y = int(cell.x / uint(size.x) % uint(size.y));
+    instance.z = int(cell.x / uint(size.x * size.y));
+    /* two triangles over the corners of the face */
+    const uint corners[6] = uint[6](0, 1, 2, 2, 1, 3);
+    uint corner = corners[uint(gl_VertexIndex) % 6];
+    uint axis = face / 2;
+    vec3 position;
+    position[axis] = face % 2 == 0 ? -0.5f : 0.5f;
+    position[(axis + 1) % 3] = float(corner & 1) - 0.5f;
+    position[(axis + 2) % 3] = float(corner >> 1) - 0.5f;
+    outValue = cell.y >> 6;
+    gl_Position = viewProjMatrix * vec4(position + vec3(instance), 1.0f);
+}
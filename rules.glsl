@@ -0,0 +1,31 @@
+layout(set = 2, binding = 0) uniform uniformRules
+{
+    uint seed;
+    uint surviveMask;
+    uint birthMask;
+    uint life;
+    uint neighborhood;
+    uint frame;
+    uint boundary;
+};
+
+/* variants define these so that branches on them fold away, and the rest read the uniforms */
+#ifndef NEIGHBORHOOD
+#define NEIGHBORHOOD neighborhood
+#endif
+#ifndef BOUNDARY
+#define BOUNDARY boundary
+#endif
+
+int Apply(int value, uint neighbors)
+{
+    if (value == 0 && ((birthMask & (1u << neighbors)) != 0))
+    {
+        value = int(life);
+    }
+    else if ((surviveMask & (1u << neighbors)) == 0)
+    {
+        value--;
+    }
+    return max(0, value);
+}
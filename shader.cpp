@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <format>
 #include <fstream>
@@ -118,7 +119,7 @@ static void* Load(SDL_GPUDevice* device, const std::string_view& name)
             {
                 assert(false);
             }
-            *value = *valueString - '0';
+            *value = std::strtoul(valueString, nullptr, 10);
         }
         info.code = reinterpret_cast<Uint8*>(shaderData.data());
         info.code_size = shaderData.size();
@@ -160,7 +161,7 @@ static void* Load(SDL_GPUDevice* device, const std::string_view& name)
             {
                 assert(false);
             }
-            *value = *valueString - '0';
+            *value = std::strtoul(valueString, nullptr, 10);
         }
         info.code = reinterpret_cast<Uint8*>(shaderData.data());
         info.code_size = shaderData.size();
@@ -0,0 +1,1093 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "config.hpp"
+#include "pool.hpp"
+#include "simulation.hpp"
+
+/* port of _fnlSinglePerlin3D from FastNoiseLite.glsl */
+static const float Gradients[] =
+{
+    0.f, 1.f, 1.f, 0.f,  0.f,-1.f, 1.f, 0.f,  0.f, 1.f,-1.f, 0.f,  0.f,-1.f,-1.f, 0.f,
+    1.f, 0.f, 1.f, 0.f, -1.f, 0.f, 1.f, 0.f,  1.f, 0.f,-1.f, 0.f, -1.f, 0.f,-1.f, 0.f,
+    1.f, 1.f, 0.f, 0.f, -1.f, 1.f, 0.f, 0.f,  1.f,-1.f, 0.f, 0.f, -1.f,-1.f, 0.f, 0.f,
+    0.f, 1.f, 1.f, 0.f,  0.f,-1.f, 1.f, 0.f,  0.f, 1.f,-1.f, 0.f,  0.f,-1.f,-1.f, 0.f,
+    1.f, 0.f, 1.f, 0.f, -1.f, 0.f, 1.f, 0.f,  1.f, 0.f,-1.f, 0.f, -1.f, 0.f,-1.f, 0.f,
+    1.f, 1.f, 0.f, 0.f, -1.f, 1.f, 0.f, 0.f,  1.f,-1.f, 0.f, 0.f, -1.f,-1.f, 0.f, 0.f,
+    0.f, 1.f, 1.f, 0.f,  0.f,-1.f, 1.f, 0.f,  0.f, 1.f,-1.f, 0.f,  0.f,-1.f,-1.f, 0.f,
+    1.f, 0.f, 1.f, 0.f, -1.f, 0.f, 1.f, 0.f,  1.f, 0.f,-1.f, 0.f, -1.f, 0.f,-1.f, 0.f,
+    1.f, 1.f, 0.f, 0.f, -1.f, 1.f, 0.f, 0.f,  1.f,-1.f, 0.f, 0.f, -1.f,-1.f, 0.f, 0.f,
+    0.f, 1.f, 1.f, 0.f,  0.f,-1.f, 1.f, 0.f,  0.f, 1.f,-1.f, 0.f,  0.f,-1.f,-1.f, 0.f,
+    1.f, 0.f, 1.f, 0.f, -1.f, 0.f, 1.f, 0.f,  1.f, 0.f,-1.f, 0.f, -1.f, 0.f,-1.f, 0.f,
+    1.f, 1.f, 0.f, 0.f, -1.f, 1.f, 0.f, 0.f,  1.f,-1.f, 0.f, 0.f, -1.f,-1.f, 0.f, 0.f,
+    0.f, 1.f, 1.f, 0.f,  0.f,-1.f, 1.f, 0.f,  0.f, 1.f,-1.f, 0.f,  0.f,-1.f,-1.f, 0.f,
+    1.f, 0.f, 1.f, 0.f, -1.f, 0.f, 1.f, 0.f,  1.f, 0.f,-1.f, 0.f, -1.f, 0.f,-1.f, 0.f,
+    1.f, 1.f, 0.f, 0.f, -1.f, 1.f, 0.f, 0.f,  1.f,-1.f, 0.f, 0.f, -1.f,-1.f, 0.f, 0.f,
+    1.f, 1.f, 0.f, 0.f,  0.f,-1.f, 1.f, 0.f, -1.f, 1.f, 0.f, 0.f,  0.f,-1.f,-1.f, 0.f
+};
+
+static constexpr int PrimeX = 501125321;
+static constexpr int PrimeY = 1136930381;
+static constexpr int PrimeZ = 1720413743;
+
+static int Multiply(int a, int b)
+{
+    /* wraps like glsl instead of overflowing */
+    return static_cast<int>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b));
+}
+
+static float Gradient(int seed, int x, int y, int z, float xd, float yd, float zd)
+{
+    int hash = Multiply(seed ^ x ^ y ^ z, 0x27d4eb2d);
+    hash ^= hash >> 15;
+    hash &= 63 << 2;
+    return xd * Gradients[hash] + yd * Gradients[hash | 1] + zd * Gradients[hash | 2];
+}
+
+static float Quintic(float t)
+{
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+static float Mix(float a, float b, float t)
+{
+    return a * (1.0f - t) + b * t;
+}
+
+static float Perlin(int seed, float x, float y, float z)
+{
+    int x0 = static_cast<int>(std::floor(x));
+    int y0 = static_cast<int>(std::floor(y));
+    int z0 = static_cast<int>(std::floor(z));
+    float xd0 = x - static_cast<float>(x0);
+    float yd0 = y - static_cast<float>(y0);
+    float zd0 = z - static_cast<float>(z0);
+    float xd1 = xd0 - 1.0f;
+    float yd1 = yd0 - 1.0f;
+    float zd1 = zd0 - 1.0f;
+    float xs = Quintic(xd0);
+    float ys = Quintic(yd0);
+    float zs = Quintic(zd0);
+    x0 = Multiply(x0, PrimeX);
+    y0 = Multiply(y0, PrimeY);
+    z0 = Multiply(z0, PrimeZ);
+    int x1 = static_cast<int>(static_cast<uint32_t>(x0) + PrimeX);
+    int y1 = static_cast<int>(static_cast<uint32_t>(y0) + PrimeY);
+    int z1 = static_cast<int>(static_cast<uint32_t>(z0) + PrimeZ);
+    float xf00 = Mix(Gradient(seed, x0, y0, z0, xd0, yd0, zd0), Gradient(seed, x1, y0, z0, xd1, yd0, zd0), xs);
+    float xf10 = Mix(Gradient(seed, x0, y1, z0, xd0, yd1, zd0), Gradient(seed, x1, y1, z0, xd1, yd1, zd0), xs);
+    float xf01 = Mix(Gradient(seed, x0, y0, z1, xd0, yd0, zd1), Gradient(seed, x1, y0, z1, xd1, yd0, zd1), xs);
+    float xf11 = Mix(Gradient(seed, x0, y1, z1, xd0, yd1, zd1), Gradient(seed, x1, y1, z1, xd1, yd1, zd1), xs);
+    float yf0 = Mix(xf00, xf10, ys);
+    float yf1 = Mix(xf01, xf11, ys);
+    return Mix(yf0, yf1, zs) * 0.964921414852142333984375f;
+}
+
+/* half open range of cells */
+struct Box
+{
+    int x1;
+    int y1;
+    int z1;
+    int x2;
+    int y2;
+    int z2;
+};
+
+static int GetIndex(const Grid& grid, int x, int y, int z)
+{
+    return ((z + 1) * (grid.height + 2) + (y + 1)) * (grid.width + 2) + (x + 1);
+}
+
+uint8_t Apply(const Rules& rules, int value, uint32_t neighbors)
+{
+    if (value == 0 && ((rules.birthMask & (1u << neighbors)) != 0))
+    {
+        value = rules.life;
+    }
+    else if ((rules.surviveMask & (1u << neighbors)) == 0)
+    {
+        value--;
+    }
+    return std::max(0, value);
+}
+
+static void Seed(Grid& grid, const Rules& rules, int z1, int z2)
+{
+    uint8_t* outCells = grid.cells[grid.writeFrame].data();
+    for (int z = z1; z < z2; z++)
+    for (int y = 0; y < grid.height; y++)
+    for (int x = 0; x < grid.width; x++)
+    {
+        float frequency = 0.1f;
+        float value = Perlin(rules.seed, x * frequency, y * frequency, z * frequency);
+        outCells[GetIndex(grid, x, y, z)] = value > 0.65f;
+    }
+}
+
+static void Copy(Grid& grid, int z1, int z2)
+{
+    int plane = (grid.width + 2) * (grid.height + 2);
+    const uint8_t* inCells = grid.cells[grid.readFrame].data() + (z1 + 1) * plane;
+    uint8_t* outCells = grid.cells[grid.writeFrame].data() + (z1 + 1) * plane;
+    std::memcpy(outCells, inCells, (z2 - z1) * plane);
+}
+
+static bool Step(Grid& grid, const Rules& rules, const Box& box)
+{
+    const uint8_t* inCells = grid.cells[grid.readFrame].data();
+    uint8_t* outCells = grid.cells[grid.writeFrame].data();
+    int pitchY = grid.width + 2;
+    int pitchZ = pitchY * (grid.height + 2);
+    int offsets[26];
+    int count = 0;
+    switch (rules.neighborhood)
+    {
+    case MOORE:
+        for (int z = -1; z <= 1; z++)
+        for (int y = -1; y <= 1; y++)
+        for (int x = -1; x <= 1; x++)
+        {
+            if (x || y || z)
+            {
+                offsets[count++] = z * pitchZ + y * pitchY + x;
+            }
+        }
+        break;
+    case VON_NEUMANN:
+        offsets[count++] = -1;
+        offsets[count++] = 1;
+        offsets[count++] = -pitchY;
+        offsets[count++] = pitchY;
+        offsets[count++] = -pitchZ;
+        offsets[count++] = pitchZ;
+        break;
+    }
+    bool changed = false;
+    for (int z = box.z1; z < box.z2; z++)
+    for (int y = box.y1; y < box.y2; y++)
+    {
+        int index = GetIndex(grid, box.x1, y, z);
+        for (int x = box.x1; x < box.x2; x++, index++)
+        {
+            uint32_t neighbors = 0;
+            for (int i = 0; i < count; i++)
+            {
+                neighbors += inCells[index + offsets[i]] > 0;
+            }
+            uint8_t value = Apply(rules, inCells[index], neighbors);
+            changed |= value != inCells[index];
+            outCells[index] = value;
+        }
+    }
+    return changed;
+}
+
+static int GetWordIndex(const Grid& grid, int w, int y, int z)
+{
+    return ((w + 1) * (grid.depth + 2) + (z + 1)) * (grid.height + 2) + (y + 1);
+}
+
+/* bit i of word w holds the cell at x = w * 64 + i, and the border along x is in the halo words on either side */
+static uint64_t GetWordMask(int w, int x1, int x2)
+{
+    int lower = std::clamp(x1 - w * 64, 0, 64);
+    int upper = std::clamp(x2 - w * 64, 0, 64);
+    uint64_t lowerMask = lower < 64 ? (1ull << lower) - 1 : ~0ull;
+    uint64_t upperMask = upper < 64 ? (1ull << upper) - 1 : ~0ull;
+    return upperMask & ~lowerMask;
+}
+
+static void Pack(Grid& grid, int z1, int z2)
+{
+    const uint8_t* cells = grid.cells[grid.readFrame].data();
+    uint64_t* alive = grid.alive[grid.readFrame].data();
+    for (int z = z1; z < z2; z++)
+    for (int y = 0; y < grid.height; y++)
+    for (int w = 0; w < grid.words; w++)
+    {
+        uint64_t word = 0;
+        int index = GetIndex(grid, w * 64, y, z);
+#if defined(__AVX2__)
+        /* only whole words are loaded at once so that loads never run past the grid */
+        if (w * 64 + 64 <= grid.width)
+        {
+            for (int half = 0; half < 2; half++)
+            {
+                __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + index + half * 32));
+                uint32_t dead = _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_setzero_si256()));
+                word |= static_cast<uint64_t>(~dead) << half * 32;
+            }
+            alive[GetWordIndex(grid, w, y, z)] = word;
+            continue;
+        }
+#endif
+        for (int i = 0; i < 64; i++)
+        {
+            int x = w * 64 + i;
+            if (x < grid.width && cells[index + i])
+            {
+                word |= 1ull << i;
+            }
+        }
+        alive[GetWordIndex(grid, w, y, z)] = word;
+    }
+}
+
+/* lanes hold the same word of neighboring rows along y, so shifts never cross lanes */
+struct Scalar
+{
+    using Type = uint64_t;
+    static constexpr int Lanes = 1;
+    static Type Load(const uint64_t* data) { return *data; }
+    static void Store(uint64_t* data, Type a) { *data = a; }
+    static Type Zero() { return 0; }
+    static Type Ones() { return ~0ull; }
+    static Type And(Type a, Type b) { return a & b; }
+    static Type AndNot(Type a, Type b) { return ~a & b; }
+    static Type Or(Type a, Type b) { return a | b; }
+    static Type Xor(Type a, Type b) { return a ^ b; }
+    template <int N> static Type ShiftLeft(Type a) { return a << N; }
+    template <int N> static Type ShiftRight(Type a) { return a >> N; }
+};
+
+#if defined(__AVX2__)
+struct Avx2
+{
+    using Type = __m256i;
+    static constexpr int Lanes = 4;
+    static Type Load(const uint64_t* data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)); }
+    static void Store(uint64_t* data, Type a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), a); }
+    static Type Zero() { return _mm256_setzero_si256(); }
+    static Type Ones() { return _mm256_set1_epi64x(-1); }
+    static Type And(Type a, Type b) { return _mm256_and_si256(a, b); }
+    static Type AndNot(Type a, Type b) { return _mm256_andnot_si256(a, b); }
+    static Type Or(Type a, Type b) { return _mm256_or_si256(a, b); }
+    static Type Xor(Type a, Type b) { return _mm256_xor_si256(a, b); }
+    template <int N> static Type ShiftLeft(Type a) { return _mm256_slli_epi64(a, N); }
+    template <int N> static Type ShiftRight(Type a) { return _mm256_srli_epi64(a, N); }
+};
+#endif
+
+#if defined(__AVX2__) && !defined(__AVX512BW__)
+/* sets each byte whose bit is set to all ones */
+static __m256i ExpandBits(uint32_t bits)
+{
+    __m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(bits),
+        _mm256_setr_epi64x(0x0000000000000000, 0x0101010101010101, 0x0202020202020202, 0x0303030303030303));
+    __m256i select = _mm256_set1_epi64x(0x8040201008040201);
+    return _mm256_cmpeq_epi8(_mm256_and_si256(bytes, select), select);
+}
+#endif
+
+#if defined(__AVX512F__)
+struct Avx512
+{
+    using Type = __m512i;
+    static constexpr int Lanes = 8;
+    static Type Load(const uint64_t* data) { return _mm512_loadu_si512(data); }
+    static void Store(uint64_t* data, Type a) { _mm512_storeu_si512(data, a); }
+    static Type Zero() { return _mm512_setzero_si512(); }
+    static Type Ones() { return _mm512_set1_epi64(-1); }
+    static Type And(Type a, Type b) { return _mm512_and_si512(a, b); }
+    static Type AndNot(Type a, Type b) { return _mm512_andnot_si512(a, b); }
+    static Type Or(Type a, Type b) { return _mm512_or_si512(a, b); }
+    static Type Xor(Type a, Type b) { return _mm512_xor_si512(a, b); }
+    template <int N> static Type ShiftLeft(Type a) { return _mm512_slli_epi64(a, N); }
+    template <int N> static Type ShiftRight(Type a) { return _mm512_srli_epi64(a, N); }
+};
+#endif
+
+/* adds a two bit number into a five bit counter */
+template <typename S>
+static void Accumulate(typename S::Type count[5], typename S::Type bit0, typename S::Type bit1)
+{
+    using V = typename S::Type;
+    V carry0 = S::And(count[0], bit0);
+    count[0] = S::Xor(count[0], bit0);
+    V sum1 = S::Xor(count[1], bit1);
+    V carry1 = S::Or(S::And(count[1], bit1), S::And(sum1, carry0));
+    count[1] = S::Xor(sum1, carry0);
+    V carry2 = S::And(count[2], carry1);
+    count[2] = S::Xor(count[2], carry1);
+    V carry3 = S::And(count[3], carry2);
+    count[3] = S::Xor(count[3], carry2);
+    count[4] = S::Xor(count[4], carry3);
+}
+
+/* sets the bits whose counter matches any of the counts in the mask */
+template <typename S>
+static typename S::Type Match(const typename S::Type count[5], uint32_t mask)
+{
+    using V = typename S::Type;
+    V result = S::Zero();
+    for (; mask; mask &= mask - 1)
+    {
+        int value = std::countr_zero(mask);
+        V equal = S::Ones();
+        for (int i = 0; i < 5; i++)
+        {
+            if ((value >> i) & 1)
+            {
+                equal = S::And(equal, count[i]);
+            }
+            else
+            {
+                equal = S::AndNot(count[i], equal);
+            }
+        }
+        result = S::Or(result, equal);
+    }
+    return result;
+}
+
+/* steps the cells of word w in the mask for a few rows and returns the bits that changed */
+template <typename S>
+static uint64_t StepBitboardRows(Grid& grid, const Rules& rules, int w, int y, int z, uint64_t mask)
+{
+    using V = typename S::Type;
+    const uint8_t* inCells = grid.cells[grid.readFrame].data();
+    uint8_t* outCells = grid.cells[grid.writeFrame].data();
+    const uint64_t* inAlive = grid.alive[grid.readFrame].data();
+    uint64_t* outAlive = grid.alive[grid.writeFrame].data();
+    int pitchZ = grid.height + 2;
+    int pitchW = pitchZ * (grid.depth + 2);
+    int center = GetWordIndex(grid, w, y, z);
+    V alive = S::Load(inAlive + center);
+    V count[5] = {S::Zero(), S::Zero(), S::Zero(), S::Zero(), S::Zero()};
+    V born;
+    V decay;
+    switch (rules.neighborhood)
+    {
+    case MOORE:
+        for (int dz = -1; dz <= 1; dz++)
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            const uint64_t* row = inAlive + center + dz * pitchZ + dy;
+            V a = S::Load(row);
+            V l = S::Or(S::template ShiftLeft<1>(a), S::template ShiftRight<63>(S::Load(row - pitchW)));
+            V r = S::Or(S::template ShiftRight<1>(a), S::template ShiftLeft<63>(S::Load(row + pitchW)));
+            V la = S::Xor(l, a);
+            Accumulate<S>(count, S::Xor(la, r), S::Or(S::And(l, a), S::And(r, la)));
+        }
+        /* the count includes the cell itself, so surviving cells see one more neighbor */
+        born = S::AndNot(alive, Match<S>(count, rules.birthMask));
+        decay = S::AndNot(Match<S>(count, rules.surviveMask << 1), alive);
+        break;
+    case VON_NEUMANN:
+        {
+            const uint64_t* row = inAlive + center;
+            V l = S::Or(S::template ShiftLeft<1>(alive), S::template ShiftRight<63>(S::Load(row - pitchW)));
+            V r = S::Or(S::template ShiftRight<1>(alive), S::template ShiftLeft<63>(S::Load(row + pitchW)));
+            V neighbors[6] = {l, r, S::Load(row - 1), S::Load(row + 1), S::Load(row - pitchZ), S::Load(row + pitchZ)};
+            for (int i = 0; i < 6; i++)
+            {
+                Accumulate<S>(count, neighbors[i], S::Zero());
+            }
+            born = S::AndNot(alive, Match<S>(count, rules.birthMask));
+            decay = S::AndNot(Match<S>(count, rules.surviveMask), alive);
+        }
+        break;
+    default:
+        return 0;
+    }
+    uint64_t aliveLanes[S::Lanes];
+    uint64_t bornLanes[S::Lanes];
+    uint64_t decayLanes[S::Lanes];
+    S::Store(aliveLanes, alive);
+    S::Store(bornLanes, born);
+    S::Store(decayLanes, decay);
+    uint64_t changed = 0;
+    for (int i = 0; i < S::Lanes; i++)
+    {
+        uint64_t a = aliveLanes[i];
+        uint64_t b = bornLanes[i] & mask;
+        uint64_t d = decayLanes[i] & mask;
+        int index = GetIndex(grid, w * 64, y + i, z);
+        changed |= b | d;
+#if defined(__AVX512BW__)
+        __m512i value = _mm512_maskz_loadu_epi8(mask, inCells + index);
+        value = _mm512_mask_sub_epi8(value, d, value, _mm512_set1_epi8(1));
+        value = _mm512_mask_mov_epi8(value, b, _mm512_set1_epi8(rules.life));
+        _mm512_mask_storeu_epi8(outCells + index, mask, value);
+        a = _mm512_test_epi8_mask(value, value);
+#elif defined(__AVX2__)
+        /* whole words are patched in place and the cells of partial ones staged so that loads never run past the grid
+         * and stores stay inside the mask */
+        int lower = std::countr_zero(mask);
+        int upper = 64 - std::countl_zero(mask);
+        alignas(32) uint8_t staged[64];
+        bool whole = mask == ~0ull;
+        const uint8_t* source = whole ? inCells + index : staged;
+        uint8_t* destination = whole ? outCells + index : staged;
+        if (!whole && lower < upper)
+        {
+            std::memcpy(staged + lower, inCells + index + lower, upper - lower);
+        }
+        for (int half = 0; half < 2 && lower < upper; half++)
+        {
+            /* decaying cells are alive so adding all ones never wraps */
+            __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + half * 32));
+            value = _mm256_add_epi8(value, ExpandBits(static_cast<uint32_t>(d >> half * 32)));
+            value = _mm256_blendv_epi8(value, _mm256_set1_epi8(rules.life), ExpandBits(static_cast<uint32_t>(b >> half * 32)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + half * 32), value);
+            uint32_t dead = _mm256_movemask_epi8(_mm256_cmpeq_epi8(value, _mm256_setzero_si256()));
+            a = (a & ~(0xffffffffull << half * 32)) | static_cast<uint64_t>(~dead) << half * 32;
+        }
+        if (!whole && lower < upper)
+        {
+            std::memcpy(outCells + index + lower, staged + lower, upper - lower);
+        }
+#else
+        /* cells that are neither born nor decay are copied and the rest patched */
+        int lower = std::countr_zero(mask);
+        int upper = 64 - std::countl_zero(mask);
+        if (lower < upper)
+        {
+            std::memcpy(outCells + index + lower, inCells + index + lower, upper - lower);
+        }
+        for (; d; d &= d - 1)
+        {
+            int bit = std::countr_zero(d);
+            uint8_t value = inCells[index + bit] - 1;
+            outCells[index + bit] = value;
+            if (value == 0)
+            {
+                a &= ~(1ull << bit);
+            }
+        }
+        for (; b; b &= b - 1)
+        {
+            int bit = std::countr_zero(b);
+            outCells[index + bit] = rules.life;
+            if (rules.life > 0)
+            {
+                a |= 1ull << bit;
+            }
+        }
+#endif
+        /* bits outside the mask belong to other boxes */
+        outAlive[center + i] = (outAlive[center + i] & ~mask) | (a & mask);
+    }
+    return changed;
+}
+
+static uint64_t StepBitboardWord(Grid& grid, const Rules& rules, int w, int y1, int y2, int z, uint64_t mask)
+{
+    uint64_t changed = 0;
+    int y = y1;
+#if defined(__AVX512F__)
+    for (; y + Avx512::Lanes <= y2; y += Avx512::Lanes)
+    {
+        changed |= StepBitboardRows<Avx512>(grid, rules, w, y, z, mask);
+    }
+#elif defined(__AVX2__)
+    for (; y + Avx2::Lanes <= y2; y += Avx2::Lanes)
+    {
+        changed |= StepBitboardRows<Avx2>(grid, rules, w, y, z, mask);
+    }
+#endif
+    for (; y < y2; y++)
+    {
+        changed |= StepBitboardRows<Scalar>(grid, rules, w, y, z, mask);
+    }
+    return changed;
+}
+
+static void StepBitboard(Grid& grid, const Rules& rules, int z1, int z2)
+{
+    for (int z = z1; z < z2; z++)
+    for (int w = 0; w < grid.words; w++)
+    {
+        StepBitboardWord(grid, rules, w, 0, grid.height, z, GetWordMask(w, 0, grid.width));
+    }
+}
+
+/* sums the 3x3 neighborhood of a plane along x and then along y */
+static void SumPlane(Grid& grid, int z, uint8_t* rowSums, uint8_t* out)
+{
+    int plane = (grid.width + 2) * (grid.height + 2);
+    /* the halo planes are summed like any other */
+    const uint8_t* inCells = grid.cells[grid.readFrame].data() + (z + 1) * plane;
+    int pitchY = grid.width + 2;
+    for (int y = -1; y <= grid.height; y++)
+    {
+        int index = (y + 1) * pitchY + 1;
+        for (int x = 0; x < grid.width; x++, index++)
+        {
+            rowSums[index] = (inCells[index - 1] > 0) + (inCells[index] > 0) + (inCells[index + 1] > 0);
+        }
+    }
+    for (int y = 0; y < grid.height; y++)
+    {
+        int index = (y + 1) * pitchY + 1;
+        for (int x = 0; x < grid.width; x++, index++)
+        {
+            out[index] = rowSums[index - pitchY] + rowSums[index] + rowSums[index + pitchY];
+        }
+    }
+}
+
+static void StepSeparable(Grid& grid, const Rules& rules, int z1, int z2, int worker)
+{
+    const uint8_t* inCells = grid.cells[grid.readFrame].data();
+    uint8_t* outCells = grid.cells[grid.writeFrame].data();
+    int plane = (grid.width + 2) * (grid.height + 2);
+    /* row sums followed by a ring of plane sums for z - 1, z and z + 1 */
+    uint8_t* rowSums = grid.sums.data() + worker * 4 * plane;
+    uint8_t* planeSums[3];
+    for (int i = 0; i < 3; i++)
+    {
+        planeSums[i] = rowSums + (i + 1) * plane;
+    }
+    SumPlane(grid, z1 - 1, rowSums, planeSums[0]);
+    SumPlane(grid, z1, rowSums, planeSums[1]);
+    uint32_t birthTotals = rules.birthMask;
+    uint32_t surviveTotals = ~(rules.surviveMask << 1);
+    uint8_t life = rules.life;
+    for (int z = z1; z < z2; z++)
+    {
+        uint8_t* below = planeSums[(z - z1) % 3];
+        uint8_t* middle = planeSums[(z - z1 + 1) % 3];
+        uint8_t* above = planeSums[(z - z1 + 2) % 3];
+        SumPlane(grid, z + 1, rowSums, above);
+        for (int y = 0; y < grid.height; y++)
+        {
+            int local = (y + 1) * (grid.width + 2) + 1;
+            int index = GetIndex(grid, 0, y, z);
+            for (int x = 0; x < grid.width; x++, local++, index++)
+            {
+                uint8_t value = inCells[index];
+                uint8_t total = below[local] + middle[local] + above[local];
+                /* the total includes the cell itself */
+                outCells[index] = value ? value - ((surviveTotals >> total) & 1) : ((birthTotals >> total) & 1) * life;
+            }
+        }
+    }
+}
+
+/* edge of the blocks for temporal blocking, so that a block and its halo stay in l2 with its scratch sums */
+static constexpr int BlockSize = 32;
+
+static int GetBlockCells(const Grid& grid)
+{
+    int size = BlockSize + 2 * grid.temporal;
+    return size * size * size;
+}
+
+/* loads a block and its halo, steps it as many generations as it has halo and stores the inside */
+static void StepBlock(Grid& grid, const Rules& rules, int block, int worker)
+{
+    int blocksX = (grid.width + BlockSize - 1) / BlockSize;
+    int blocksY = (grid.height + BlockSize - 1) / BlockSize;
+    int halo = grid.temporal;
+    int size = BlockSize + 2 * halo;
+    int x1 = block % blocksX * BlockSize - halo;
+    int y1 = block / blocksX % blocksY * BlockSize - halo;
+    int z1 = block / (blocksX * blocksY) * BlockSize - halo;
+    bool periodic = rules.boundary == BOUNDARY_PERIODIC;
+    const uint8_t* inCells = grid.cells[grid.readFrame].data();
+    uint8_t* outCells = grid.cells[grid.writeFrame].data();
+    uint8_t* buffers[2];
+    buffers[0] = grid.blocks.data() + 4 * worker * GetBlockCells(grid);
+    buffers[1] = buffers[0] + GetBlockCells(grid);
+    uint8_t* sumsX = buffers[1] + GetBlockCells(grid);
+    uint8_t* sumsY = sumsX + GetBlockCells(grid);
+    auto wrap = [](int value, int size)
+    {
+        return (value % size + size) % size;
+    };
+    for (int z = 0; z < size; z++)
+    for (int y = 0; y < size; y++)
+    {
+        uint8_t* row = buffers[0] + (z * size + y) * size;
+        int cellY = periodic ? wrap(y1 + y, grid.height) : y1 + y;
+        int cellZ = periodic ? wrap(z1 + z, grid.depth) : z1 + z;
+        if (cellY < 0 || cellY >= grid.height || cellZ < 0 || cellZ >= grid.depth)
+        {
+            std::memset(row, 0, size);
+        }
+        else
+        {
+            /* copied in runs that end at the edges of the grid */
+            for (int x = 0; x < size;)
+            {
+                int cellX = periodic ? wrap(x1 + x, grid.width) : x1 + x;
+                int count;
+                if (cellX < 0)
+                {
+                    count = std::min(size - x, -cellX);
+                    std::memset(row + x, 0, count);
+                }
+                else if (cellX >= grid.width)
+                {
+                    count = size - x;
+                    std::memset(row + x, 0, count);
+                }
+                else
+                {
+                    count = std::min(size - x, grid.width - cellX);
+                    std::memcpy(row + x, inCells + GetIndex(grid, cellX, cellY, cellZ), count);
+                }
+                x += count;
+            }
+        }
+        /* cells outside of dead grids stay dead in both copies */
+        std::memcpy(buffers[1] + (z * size + y) * size, row, size);
+    }
+    int pitch = size * size;
+    uint32_t birthTotals = rules.birthMask;
+    uint32_t surviveTotals = ~(rules.surviveMask << 1);
+    uint8_t life = rules.life;
+    /* the valid part shrinks by a cell on each side per generation */
+    for (int generation = 1; generation <= halo; generation++)
+    {
+        const uint8_t* in = buffers[(generation - 1) % 2];
+        uint8_t* out = buffers[generation % 2];
+        int lowerX = generation;
+        int lowerY = generation;
+        int lowerZ = generation;
+        int upperX = size - generation;
+        int upperY = size - generation;
+        int upperZ = size - generation;
+        if (!periodic)
+        {
+            lowerX = std::max(lowerX, -x1);
+            lowerY = std::max(lowerY, -y1);
+            lowerZ = std::max(lowerZ, -z1);
+            upperX = std::min(upperX, grid.width - x1);
+            upperY = std::min(upperY, grid.height - y1);
+            upperZ = std::min(upperZ, grid.depth - z1);
+        }
+        if (rules.neighborhood == VON_NEUMANN)
+        {
+            for (int z = lowerZ; z < upperZ; z++)
+            for (int y = lowerY; y < upperY; y++)
+            {
+                int index = z * pitch + y * size + lowerX;
+                for (int x = lowerX; x < upperX; x++, index++)
+                {
+                    uint32_t neighbors =
+                        (in[index - 1] > 0) + (in[index + 1] > 0) +
+                        (in[index - size] > 0) + (in[index + size] > 0) +
+                        (in[index - pitch] > 0) + (in[index + pitch] > 0);
+                    out[index] = Apply(rules, in[index], neighbors);
+                }
+            }
+            continue;
+        }
+        /* the block is in cache so moore neighbors are summed along x, y and then z like separable counting */
+        for (int z = lowerZ - 1; z < upperZ + 1; z++)
+        for (int y = lowerY - 1; y < upperY + 1; y++)
+        {
+            int index = z * pitch + y * size + lowerX;
+            for (int x = lowerX; x < upperX; x++, index++)
+            {
+                sumsX[index] = (in[index - 1] > 0) + (in[index] > 0) + (in[index + 1] > 0);
+            }
+        }
+        for (int z = lowerZ - 1; z < upperZ + 1; z++)
+        for (int y = lowerY; y < upperY; y++)
+        {
+            int index = z * pitch + y * size + lowerX;
+            for (int x = lowerX; x < upperX; x++, index++)
+            {
+                sumsY[index] = sumsX[index - size] + sumsX[index] + sumsX[index + size];
+            }
+        }
+        for (int z = lowerZ; z < upperZ; z++)
+        for (int y = lowerY; y < upperY; y++)
+        {
+            int index = z * pitch + y * size + lowerX;
+            for (int x = lowerX; x < upperX; x++, index++)
+            {
+                uint8_t value = in[index];
+                uint8_t total = sumsY[index - pitch] + sumsY[index] + sumsY[index + pitch];
+                /* the total includes the cell itself */
+                out[index] = value ? value - ((surviveTotals >> total) & 1) : ((birthTotals >> total) & 1) * life;
+            }
+        }
+    }
+    const uint8_t* result = buffers[halo % 2];
+    for (int z = halo; z < halo + BlockSize && z1 + z < grid.depth; z++)
+    for (int y = halo; y < halo + BlockSize && y1 + y < grid.height; y++)
+    {
+        int width = std::min(BlockSize, grid.width - (x1 + halo));
+        std::memcpy(outCells + GetIndex(grid, x1 + halo, y1 + y, z1 + z), result + (z * size + y) * size + halo, width);
+    }
+}
+
+void CreateGrid(Grid& grid, int width, int height, int depth)
+{
+    grid.width = width;
+    grid.height = height;
+    grid.depth = depth;
+    for (int i = 0; i < GRIDS; i++)
+    {
+        grid.cells[i].assign((width + 2) * (height + 2) * (depth + 2), 0);
+    }
+    grid.words = (width + 63) / 64;
+    for (int i = 0; i < GRIDS; i++)
+    {
+        grid.alive[i].assign((grid.words + 2) * (height + 2) * (depth + 2), 0);
+    }
+    grid.packed = false;
+    grid.sums.assign(4 * (width + 2) * (height + 2), 0);
+    grid.bricksX = (width + THREADS - 1) / THREADS;
+    grid.bricksY = (height + THREADS - 1) / THREADS;
+    grid.bricksZ = (depth + THREADS - 1) / THREADS;
+    grid.changed.assign(grid.bricksX * grid.bricksY * grid.bricksZ, 0);
+    grid.active.clear();
+    grid.tracked = false;
+    grid.readFrame = 0;
+    grid.writeFrame = 1;
+}
+
+/* x first, then y including the x halo and then z including both, so that edges and corners wrap too */
+static void FillCellHalo(Grid& grid, bool periodic)
+{
+    uint8_t* cells = grid.cells[grid.readFrame].data();
+    int pitchY = grid.width + 2;
+    int pitchZ = pitchY * (grid.height + 2);
+    for (int z = 0; z < grid.depth; z++)
+    for (int y = 0; y < grid.height; y++)
+    {
+        uint8_t* row = cells + GetIndex(grid, 0, y, z);
+        row[-1] = periodic ? row[grid.width - 1] : 0;
+        row[grid.width] = periodic ? row[0] : 0;
+    }
+    for (int z = 0; z < grid.depth; z++)
+    {
+        uint8_t* first = cells + GetIndex(grid, -1, 0, z);
+        uint8_t* last = first + (grid.height - 1) * pitchY;
+        if (periodic)
+        {
+            std::memcpy(first - pitchY, last, pitchY);
+            std::memcpy(last + pitchY, first, pitchY);
+        }
+        else
+        {
+            std::memset(first - pitchY, 0, pitchY);
+            std::memset(last + pitchY, 0, pitchY);
+        }
+    }
+    uint8_t* first = cells + GetIndex(grid, -1, -1, 0);
+    uint8_t* last = first + (grid.depth - 1) * pitchZ;
+    if (periodic)
+    {
+        std::memcpy(first - pitchZ, last, pitchZ);
+        std::memcpy(last + pitchZ, first, pitchZ);
+    }
+    else
+    {
+        std::memset(first - pitchZ, 0, pitchZ);
+        std::memset(last + pitchZ, 0, pitchZ);
+    }
+}
+
+/* same as the cells but with the halo along x stored as bits in the halo words or past the last cell of the last word */
+static void FillAliveHalo(Grid& grid, bool periodic)
+{
+    uint64_t* alive = grid.alive[grid.readFrame].data();
+    int pitchW = (grid.height + 2) * (grid.depth + 2);
+    /* x is at least -1 so shifting it up by a word keeps the division and remainder positive */
+    auto getWord = [&](uint64_t* row, int x) -> uint64_t&
+    {
+        return row[((x + 64) / 64 - 1) * pitchW];
+    };
+    auto getBit = [&](uint64_t* row, int x) -> uint64_t
+    {
+        return (getWord(row, x) >> ((x + 64) % 64)) & 1;
+    };
+    auto setBit = [&](uint64_t* row, int x, uint64_t bit)
+    {
+        uint64_t& word = getWord(row, x);
+        word = (word & ~(1ull << ((x + 64) % 64))) | (bit << ((x + 64) % 64));
+    };
+    for (int z = 0; z < grid.depth; z++)
+    for (int y = 0; y < grid.height; y++)
+    {
+        uint64_t* row = alive + GetWordIndex(grid, 0, y, z);
+        setBit(row, -1, periodic ? getBit(row, grid.width - 1) : 0);
+        setBit(row, grid.width, periodic ? getBit(row, 0) : 0);
+    }
+    /* the halo words along x hold the border of the rows next to the grid too */
+    for (int w = -1; w <= grid.words; w++)
+    {
+        for (int z = 0; z < grid.depth; z++)
+        {
+            uint64_t* column = alive + GetWordIndex(grid, w, 0, z);
+            column[-1] = periodic ? column[grid.height - 1] : 0;
+            column[grid.height] = periodic ? column[0] : 0;
+        }
+        int pitchZ = grid.height + 2;
+        uint64_t* first = alive + GetWordIndex(grid, w, -1, 0);
+        uint64_t* last = first + (grid.depth - 1) * pitchZ;
+        if (periodic)
+        {
+            std::memcpy(first - pitchZ, last, pitchZ * sizeof(uint64_t));
+            std::memcpy(last + pitchZ, first, pitchZ * sizeof(uint64_t));
+        }
+        else
+        {
+            std::memset(first - pitchZ, 0, pitchZ * sizeof(uint64_t));
+            std::memset(last + pitchZ, 0, pitchZ * sizeof(uint64_t));
+        }
+    }
+}
+
+/* runs the function over slabs of [0, depth), on the pool when the grid has one */
+static void ForSlabs(Grid& grid, int depth, const std::function<void(int z1, int z2, int worker)>& function)
+{
+    if (!grid.pool)
+    {
+        function(0, depth, 0);
+        return;
+    }
+    /* a few slabs per thread so that idle threads have something to steal */
+    int slabs = std::min(depth, GetPoolThreads(*grid.pool) * 4);
+    RunPool(*grid.pool, slabs, [&](int task, int worker)
+    {
+        function(task * depth / slabs, (task + 1) * depth / slabs, worker);
+    });
+}
+
+static bool IsSameRules(const Rules& a, const Rules& b)
+{
+    return a.surviveMask == b.surviveMask && a.birthMask == b.birthMask &&
+        a.life == b.life && a.neighborhood == b.neighborhood && a.boundary == b.boundary;
+}
+
+/* a brick is active when it or any of its neighbors changed in the last step */
+static void GatherBricks(Grid& grid, bool all, bool periodic)
+{
+    grid.active.clear();
+    for (int z = 0; z < grid.bricksZ; z++)
+    for (int y = 0; y < grid.bricksY; y++)
+    for (int x = 0; x < grid.bricksX; x++)
+    {
+        bool active = all;
+        for (int dz = -1; dz <= 1 && !active; dz++)
+        for (int dy = -1; dy <= 1 && !active; dy++)
+        for (int dx = -1; dx <= 1 && !active; dx++)
+        {
+            int nx = x + dx;
+            int ny = y + dy;
+            int nz = z + dz;
+            if (periodic)
+            {
+                nx = (nx + grid.bricksX) % grid.bricksX;
+                ny = (ny + grid.bricksY) % grid.bricksY;
+                nz = (nz + grid.bricksZ) % grid.bricksZ;
+            }
+            if (nx < 0 || ny < 0 || nz < 0 || nx >= grid.bricksX || ny >= grid.bricksY || nz >= grid.bricksZ)
+            {
+                continue;
+            }
+            active = grid.changed[(nz * grid.bricksY + ny) * grid.bricksX + nx];
+        }
+        if (active)
+        {
+            grid.active.push_back((z * grid.bricksY + y) * grid.bricksX + x);
+        }
+    }
+    std::fill(grid.changed.begin(), grid.changed.end(), 0);
+}
+
+/* steps the active bricks of a single row along x */
+static void StepBricks(Grid& grid, const Rules& rules, const int* begin, const int* end)
+{
+    int row = *begin / grid.bricksX;
+    int y1 = row % grid.bricksY * THREADS;
+    int z1 = row / grid.bricksY * THREADS;
+    int y2 = std::min(y1 + THREADS, grid.height);
+    int z2 = std::min(z1 + THREADS, grid.depth);
+    auto getX = [&](int brick, int& x1, int& x2)
+    {
+        x1 = brick % grid.bricksX * THREADS;
+        x2 = std::min(x1 + THREADS, grid.width);
+    };
+    int x1;
+    int x2;
+    if (grid.counting != COUNTING_BITBOARD)
+    {
+        for (const int* brick = begin; brick != end; brick++)
+        {
+            getX(*brick, x1, x2);
+            if (Step(grid, rules, {x1, y1, z1, x2, y2, z2}))
+            {
+                grid.changed[*brick] = 1;
+            }
+        }
+        return;
+    }
+    /* a word spans several bricks so it is stepped once for all of its active bricks */
+    int last;
+    getX(*begin, x1, last);
+    getX(*(end - 1), last, x2);
+    for (int w = x1 / 64; w <= (x2 - 1) / 64; w++)
+    {
+        uint64_t mask = 0;
+        for (const int* brick = begin; brick != end; brick++)
+        {
+            getX(*brick, x1, x2);
+            mask |= GetWordMask(w, x1, x2);
+        }
+        if (!mask)
+        {
+            continue;
+        }
+        uint64_t changed = 0;
+        for (int z = z1; z < z2; z++)
+        {
+            changed |= StepBitboardWord(grid, rules, w, y1, y2, z, mask);
+        }
+        for (const int* brick = begin; brick != end; brick++)
+        {
+            getX(*brick, x1, x2);
+            if (changed & GetWordMask(w, x1, x2))
+            {
+                grid.changed[*brick] = 1;
+            }
+        }
+    }
+}
+
+/*
+ * inactive bricks are skipped entirely: their cells were equal in both frames after the
+ * last step so the write frame already holds their next state
+ */
+static void StepSparse(Grid& grid, const Rules& rules, bool packed)
+{
+    /* the alive bits of the write frame are stale right after packing */
+    bool all = !grid.tracked || !IsSameRules(rules, grid.trackedRules) || packed;
+    GatherBricks(grid, all, rules.boundary == BOUNDARY_PERIODIC);
+    int layer = grid.bricksX * grid.bricksY;
+    /* words span several bricks along x, so each task owns whole layers along z */
+    ForSlabs(grid, grid.bricksZ, [&](int z1, int z2, int)
+    {
+        const int* active = grid.active.data();
+        const int* begin = std::lower_bound(active, active + grid.active.size(), z1 * layer);
+        const int* end = std::lower_bound(active, active + grid.active.size(), z2 * layer);
+        while (begin != end)
+        {
+            int row = *begin / grid.bricksX;
+            const int* next = std::find_if(begin, end, [&](int brick)
+            {
+                return brick / grid.bricksX != row;
+            });
+            StepBricks(grid, rules, begin, next);
+            begin = next;
+        }
+    });
+    grid.trackedRules = rules;
+}
+
+void StepGrid(Grid& grid, Rules& rules)
+{
+    /* temporal blocking counts directly and fills its own halo */
+    int generations = rules.frame > 1 ? std::max(grid.temporal, 1) : 1;
+    bool sparse = grid.sparse && rules.frame > 1 && generations == 1;
+    bool packing = rules.frame > 1 && generations == 1 && grid.counting == COUNTING_BITBOARD && !grid.packed;
+    if (packing)
+    {
+        ForSlabs(grid, grid.depth, [&](int z1, int z2, int)
+        {
+            Pack(grid, z1, z2);
+        });
+    }
+    if (rules.frame > 1 && generations == 1 && grid.counting == COUNTING_BITBOARD)
+    {
+        FillAliveHalo(grid, rules.boundary == BOUNDARY_PERIODIC);
+    }
+    else if (rules.frame > 1 && generations == 1)
+    {
+        FillCellHalo(grid, rules.boundary == BOUNDARY_PERIODIC);
+    }
+    if (rules.frame == 0)
+    {
+        ForSlabs(grid, grid.depth, [&](int z1, int z2, int)
+        {
+            Seed(grid, rules, z1, z2);
+        });
+    }
+    else if (rules.frame == 1)
+    {
+        ForSlabs(grid, grid.depth, [&](int z1, int z2, int)
+        {
+            Copy(grid, z1, z2);
+        });
+    }
+    else if (grid.temporal > 1)
+    {
+        int blocks =
+            ((grid.width + BlockSize - 1) / BlockSize) *
+            ((grid.height + BlockSize - 1) / BlockSize) *
+            ((grid.depth + BlockSize - 1) / BlockSize);
+        int workers = grid.pool ? GetPoolThreads(*grid.pool) : 1;
+        grid.blocks.resize(4 * workers * GetBlockCells(grid));
+        ForSlabs(grid, blocks, [&](int block1, int block2, int worker)
+        {
+            for (int block = block1; block < block2; block++)
+            {
+                StepBlock(grid, rules, block, worker);
+            }
+        });
+    }
+    else if (sparse)
+    {
+        /* separable counting works on whole planes so sparse steps count directly instead */
+        StepSparse(grid, rules, packing);
+    }
+    else if (grid.counting == COUNTING_BITBOARD)
+    {
+        ForSlabs(grid, grid.depth, [&](int z1, int z2, int)
+        {
+            StepBitboard(grid, rules, z1, z2);
+        });
+    }
+    else if (grid.counting == COUNTING_SEPARABLE && rules.neighborhood == MOORE)
+    {
+        /* von neumann is not a box so it always counts directly */
+        int workers = grid.pool ? GetPoolThreads(*grid.pool) : 1;
+        grid.sums.resize(workers * 4 * (grid.width + 2) * (grid.height + 2));
+        ForSlabs(grid, grid.depth, [&](int z1, int z2, int worker)
+        {
+            StepSeparable(grid, rules, z1, z2, worker);
+        });
+    }
+    else
+    {
+        ForSlabs(grid, grid.depth, [&](int z1, int z2, int)
+        {
+            Step(grid, rules, {0, 0, z1, grid.width, grid.height, z2});
+        });
+    }
+    grid.packed = rules.frame > 1 && generations == 1 && grid.counting == COUNTING_BITBOARD;
+    grid.tracked = sparse;
+    grid.readFrame = (grid.readFrame + 1) % GRIDS;
+    grid.writeFrame = (grid.writeFrame + 1) % GRIDS;
+    rules.frame += generations;
+}
+
+uint8_t GetCell(const Grid& grid, int x, int y, int z)
+{
+    return grid.cells[grid.readFrame][GetIndex(grid, x, y, z)];
+}
+
+void SetCell(Grid& grid, int x, int y, int z, uint8_t value)
+{
+    grid.cells[grid.readFrame][GetIndex(grid, x, y, z)] = value;
+    /* the packed and tracked state no longer match the cells */
+    grid.packed = false;
+    grid.tracked = false;
+}
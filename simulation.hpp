@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "config.hpp"
+#include "pool.hpp"
+
+struct Rules
+{
+    uint32_t seed{0};
+    uint32_t surviveMask{16};
+    uint32_t birthMask{96};
+    uint32_t life{32};
+    uint32_t neighborhood{MOORE};
+    uint32_t frame{0};
+    uint32_t boundary{BOUNDARY_DEAD};
+};
+
+/* cells are stored x-major with a one cell halo that is dead or wraps around before each step */
+struct Grid
+{
+    int width;
+    int height;
+    int depth;
+    int counting{COUNTING_DIRECT};
+    /* steps slabs along z in parallel when set */
+    Pool* pool{nullptr};
+    std::vector<uint8_t> cells[GRIDS];
+    /* one bit per cell (64 cells per word along x) stored word-major so that rows along y are contiguous */
+    std::vector<uint64_t> alive[GRIDS];
+    int words;
+    bool packed{false};
+    /* scratch planes for separable counting, per worker */
+    std::vector<uint8_t> sums;
+    /* generations per step, stepped in cache sized blocks with a halo of as many cells when more than one */
+    int temporal{1};
+    /* scratch blocks and sums for temporal blocking, per worker */
+    std::vector<uint8_t> blocks;
+    /* only steps bricks of THREADS cells whose neighborhood changed in the last step when set */
+    bool sparse{false};
+    int bricksX;
+    int bricksY;
+    int bricksZ;
+    std::vector<uint8_t> changed;
+    /* sorted so that bricks are grouped by layer along z */
+    std::vector<int> active;
+    /* the changed flags are only valid for consecutive sparse steps with the same rules */
+    bool tracked{false};
+    Rules trackedRules;
+    int readFrame{0};
+    int writeFrame{1};
+};
+
+void CreateGrid(Grid& grid, int width, int height, int depth);
+void StepGrid(Grid& grid, Rules& rules);
+uint8_t GetCell(const Grid& grid, int x, int y, int z);
+void SetCell(Grid& grid, int x, int y, int z, uint8_t value);
+uint8_t Apply(const Rules& rules, int value, uint32_t neighbors);
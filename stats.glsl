@@ -0,0 +1,108 @@
+/* reduces a frame to its population, births and deaths since the previous frame, bounds and ages, reading cells with GetCell and GetPrevious from the includer */
+layout(set = 1, binding = 0) buffer statsBuffer
+{
+    uint alive;
+    uint births;
+    uint deaths;
+    uint minimum[3];
+    uint maximum[3];
+    uint ages[STATS_AGES];
+};
+layout(set = 2, binding = 0) uniform uniformClear
+{
+    uint clear;
+};
+
+shared uint sharedAlive;
+shared uint sharedBirths;
+shared uint sharedDeaths;
+shared uint sharedMinimum[3];
+shared uint sharedMaximum[3];
+shared uint sharedAges[STATS_AGES];
+
+void Measure(ivec3 id, ivec3 size)
+{
+    uint index = gl_LocalInvocationIndex;
+    /* a single group resets the totals in a pass of its own before they are accumulated */
+    if (clear != 0)
+    {
+        if (index == 0)
+        {
+            alive = 0;
+            births = 0;
+            deaths = 0;
+        }
+        if (index < 3)
+        {
+            minimum[index] = 0xFFFFFFFFu;
+            maximum[index] = 0;
+        }
+        if (index < STATS_AGES)
+        {
+            ages[index] = 0;
+        }
+        return;
+    }
+    if (index == 0)
+    {
+        sharedAlive = 0;
+        sharedBirths = 0;
+        sharedDeaths = 0;
+    }
+    if (index < 3)
+    {
+        sharedMinimum[index] = 0xFFFFFFFFu;
+        sharedMaximum[index] = 0;
+    }
+    if (index < STATS_AGES)
+    {
+        sharedAges[index] = 0;
+    }
+    barrier();
+    if (all(lessThan(id, size)))
+    {
+        uint value = GetCell(id);
+        uint previous = GetPrevious(id);
+        if (value > 0)
+        {
+            atomicAdd(sharedAlive, 1);
+            atomicAdd(sharedAges[min(value, uint(STATS_AGES)) - 1], 1);
+            for (int i = 0; i < 3; i++)
+            {
+                atomicMin(sharedMinimum[i], uint(id[i]));
+                atomicMax(sharedMaximum[i], uint(id[i]));
+            }
+        }
+        if (value > 0 && previous == 0)
+        {
+            atomicAdd(sharedBirths, 1);
+        }
+        else if (value == 0 && previous > 0)
+        {
+            atomicAdd(sharedDeaths, 1);
+        }
+    }
+    barrier();
+    /* one atomic per group and total rather than per cell */
+    if (index == 0 && sharedAlive > 0)
+    {
+        atomicAdd(alive, sharedAlive);
+    }
+    if (index == 1 && sharedBirths > 0)
+    {
+        atomicAdd(births, sharedBirths);
+    }
+    if (index == 2 && sharedDeaths > 0)
+    {
+        atomicAdd(deaths, sharedDeaths);
+    }
+    if (index < 3 && sharedAlive > 0)
+    {
+        atomicMin(minimum[index], sharedMinimum[index]);
+        atomicMax(maximum[index], sharedMaximum[index]);
+    }
+    if (index < STATS_AGES && sharedAges[index] > 0)
+    {
+        atomicAdd(ages[index], sharedAges[index]);
+    }
+}
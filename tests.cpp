@@ -0,0 +1,217 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "config.hpp"
+#include "hashlife.hpp"
+#include "pool.hpp"
+#include "simulation.hpp"
+
+/* generations stepped past seeding and copying, a multiple of every temporal depth */
+static constexpr int Generations = 12;
+static constexpr int Cases = 60;
+static constexpr int Jumps = 40;
+
+struct Mode
+{
+    const char* name;
+    int counting;
+    bool pooled;
+    bool sparse;
+    int temporal;
+};
+
+static const Mode modes[] =
+{
+    {"bitboard", COUNTING_BITBOARD, false, false, 1},
+    {"separable", COUNTING_SEPARABLE, false, false, 1},
+    {"pool", COUNTING_DIRECT, true, false, 1},
+    {"pool bitboard", COUNTING_BITBOARD, true, false, 1},
+    {"pool separable", COUNTING_SEPARABLE, true, false, 1},
+    {"sparse", COUNTING_DIRECT, false, true, 1},
+    {"sparse bitboard", COUNTING_BITBOARD, false, true, 1},
+    {"sparse pool", COUNTING_DIRECT, true, true, 1},
+    {"temporal 2", COUNTING_DIRECT, false, false, 2},
+    {"temporal 3", COUNTING_DIRECT, false, false, 3},
+    {"temporal 4", COUNTING_DIRECT, false, false, 4},
+    {"temporal 4 pool", COUNTING_DIRECT, true, false, 4},
+};
+
+/* sizes that are neither multiples of 64 nor of THREADS so that partial words and bricks are covered */
+static int GetSize(std::mt19937& random)
+{
+    int size = std::uniform_int_distribution<int>(1, 70)(random);
+    return size % THREADS == 0 ? size + 1 : size;
+}
+
+/* each neighbor count is set with the given chance so that grids neither die out nor fill at once */
+static uint32_t GetMask(std::mt19937& random, int counts, float chance)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < counts; i++)
+    {
+        if (std::uniform_real_distribution<float>(0.0f, 1.0f)(random) < chance)
+        {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+/* steps the grid until the rules reach the frame, which temporal blocking can only hit in whole passes */
+static void StepTo(Grid& grid, Rules& rules, uint32_t frame)
+{
+    while (rules.frame < frame)
+    {
+        StepGrid(grid, rules);
+    }
+}
+
+static bool Compare(const Grid& a, const Grid& b, int& x, int& y, int& z)
+{
+    for (z = 0; z < a.depth; z++)
+    for (y = 0; y < a.height; y++)
+    for (x = 0; x < a.width; x++)
+    {
+        if (GetCell(a, x, y, z) != GetCell(b, x, y, z))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* steps every mode from the same random grid and rules and checks them against direct counting on one thread */
+static int TestModes(std::mt19937& random, Pool& pool)
+{
+    int failures = 0;
+    for (int i = 0; i < Cases; i++)
+    {
+        int width = GetSize(random);
+        int height = GetSize(random);
+        int depth = GetSize(random);
+        Rules rules;
+        rules.seed = random();
+        rules.neighborhood = random() % 2 ? MOORE : VON_NEUMANN;
+        rules.boundary = random() % 2 ? BOUNDARY_DEAD : BOUNDARY_PERIODIC;
+        int counts = rules.neighborhood == MOORE ? 27 : 7;
+        rules.surviveMask = GetMask(random, counts, 0.3f);
+        rules.birthMask = GetMask(random, counts, 0.15f);
+        /* births with no neighbors fill empty space, which sparse stepping must not skip */
+        if (i % 4 == 0)
+        {
+            rules.birthMask |= 1;
+        }
+        rules.life = std::uniform_int_distribution<int>(1, 40)(random);
+        /* noise on top of the seed so that small grids are not empty */
+        int cells = width * height * depth / 8;
+        std::vector<int> noise(4 * cells);
+        for (int j = 0; j < cells; j++)
+        {
+            noise[4 * j + 0] = random() % width;
+            noise[4 * j + 1] = random() % height;
+            noise[4 * j + 2] = random() % depth;
+            noise[4 * j + 3] = random() % (rules.life + 1);
+        }
+        auto create = [&](Grid& grid, Rules& gridRules)
+        {
+            CreateGrid(grid, width, height, depth);
+            gridRules = rules;
+            StepTo(grid, gridRules, 2);
+            for (int j = 0; j < cells; j++)
+            {
+                SetCell(grid, noise[4 * j + 0], noise[4 * j + 1], noise[4 * j + 2], noise[4 * j + 3]);
+            }
+        };
+        Grid reference;
+        Rules referenceRules;
+        create(reference, referenceRules);
+        StepTo(reference, referenceRules, 2 + Generations);
+        for (const Mode& mode : modes)
+        {
+            Grid grid;
+            Rules gridRules;
+            create(grid, gridRules);
+            grid.counting = mode.counting;
+            grid.pool = mode.pooled ? &pool : nullptr;
+            grid.sparse = mode.sparse;
+            grid.temporal = mode.temporal;
+            StepTo(grid, gridRules, 2 + Generations);
+            int x;
+            int y;
+            int z;
+            if (!Compare(reference, grid, x, y, z))
+            {
+                std::printf("%s: %dx%dx%d, neighborhood %u, boundary %u, survive %x, birth %x, life %u, differs at (%d, %d, %d)\n",
+                    mode.name, width, height, depth, rules.neighborhood, rules.boundary,
+                    rules.surviveMask, rules.birthMask, rules.life, x, y, z);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+/* jumps random grids ahead and checks them against stepping one generation at a time, with some octrees small enough to be collected */
+static int TestJumps(std::mt19937& random)
+{
+    int failures = 0;
+    for (int i = 0; i < Jumps; i++)
+    {
+        int width = GetSize(random) / 2 + 1;
+        int height = GetSize(random) / 2 + 1;
+        int depth = GetSize(random) / 2 + 1;
+        Rules rules;
+        rules.seed = random();
+        rules.neighborhood = random() % 2 ? MOORE : VON_NEUMANN;
+        rules.boundary = random() % 4 ? BOUNDARY_DEAD : BOUNDARY_PERIODIC;
+        int counts = rules.neighborhood == MOORE ? 27 : 7;
+        rules.surviveMask = GetMask(random, counts, 0.3f);
+        rules.birthMask = GetMask(random, counts, 0.15f);
+        rules.life = std::uniform_int_distribution<int>(1, 8)(random);
+        /* the longest life fills every bit of a cell */
+        if (i % 8 == 0)
+        {
+            rules.life = 255;
+        }
+        uint64_t generations = std::uniform_int_distribution<int>(1, 40)(random);
+        size_t capacity = i % 2 ? 64 : 1 << 16;
+        Grid reference;
+        Rules referenceRules = rules;
+        CreateGrid(reference, width, height, depth);
+        /* seeding and copying count as two */
+        StepTo(reference, referenceRules, 2 + generations);
+        Grid grid;
+        Rules gridRules = rules;
+        CreateGrid(grid, width, height, depth);
+        Hashlife hashlife;
+        CreateHashlife(hashlife, capacity);
+        /* split in two so that the memoized results are reused */
+        JumpGrid(hashlife, grid, gridRules, 2 + generations / 2);
+        JumpGrid(hashlife, grid, gridRules, generations - generations / 2);
+        int x = 0;
+        int y = 0;
+        int z = 0;
+        if (gridRules.frame != referenceRules.frame || !Compare(reference, grid, x, y, z))
+        {
+            std::printf("jump %llu: %dx%dx%d, capacity %zu, neighborhood %u, boundary %u, survive %x, birth %x, life %u, differs at (%d, %d, %d)\n",
+                static_cast<unsigned long long>(generations), width, height, depth, capacity, rules.neighborhood,
+                rules.boundary, rules.surviveMask, rules.birthMask, rules.life, x, y, z);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main()
+{
+    std::mt19937 random(1);
+    Pool pool;
+    CreatePool(pool, 4);
+    int failures = TestModes(random, pool);
+    DestroyPool(pool);
+    failures += TestJumps(random);
+    std::printf("%d failures\n", failures);
+    return failures > 0;
+}